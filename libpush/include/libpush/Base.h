@@ -82,3 +82,4 @@ inline void Sleep( f64 ms_duration ) {
 class Worker;
 class GlobalCtx;
 class UnitCtx;
+class JobsBuilder;
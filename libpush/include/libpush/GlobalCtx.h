@@ -17,6 +17,8 @@
 #include "libpush/Worker.h"
 #include "libpush/Preferences.h"
 #include "libpush/util/FunctionHash.h"
+#include "libpush/util/PassStats.h"
+#include "libpush/util/StringInterner.h"
 
 // Stores meta information about a query
 struct QueryCacheHead {
@@ -70,6 +72,13 @@ class GlobalCtx : public std::enable_shared_from_this<GlobalCtx> {
     std::vector<std::pair<MessageType, MessageInfo>> message_log; // stores all messages internally
 
 
+    sptr<StringInterner> interner = StringInterner::get_global(); // shared by all compilation units
+
+
+    Mutex pass_stats_mtx; // used for async pass stats access
+    std::vector<PassStats> pass_stats; // accumulated stats of each compiler stage in order of their first start
+
+
     template <typename FuncT, typename... Args>
     auto query_impl( FuncT fn, sptr<Worker> w_ctx, const Args &... args ) -> decltype( auto );
 
@@ -166,12 +175,34 @@ public:
             throw AbortCompilationError();
     }
 
+    // Prints a message which was collected in a message buffer of a worker
+    void print_deferred_msg( const DeferredMessage &message ) {
+        message_log.push_back( std::make_pair( message.type, message.info ) );
+        print_msg_to_stdout( message.str );
+    }
+
+    // Returns the unique id of a file path. The id is created if the file was not known before. The ids are shared
+    // with SourceStore::get_file_id()
+    u32 get_file_id( const sptr<String> &file );
+
+    // Returns the path of a file id
+    sptr<String> get_file_path( u32 file_id );
+
+    // Returns the global string interner
+    sptr<StringInterner> get_interner() { return interner; }
+
     // Returns a read-only reference to the internal message log
     const std::vector<std::pair<MessageType, MessageInfo>> &get_message_log() { return message_log; }
 
     // Deletes all internally stored messages
     void clear_messages() { message_log.clear(); }
 
+    // Adds a run of a compiler stage to the stats of the stage with the same name
+    void add_pass_stats( const PassStats &run );
+
+    // Returns the accumulated stats of all measured compiler stages in order of their first start
+    std::vector<PassStats> get_pass_stats();
+
 
     // Returns a previously saved pref. If it was not saved, returns the default value for the preference type.
     template <typename ValT>
@@ -128,6 +128,13 @@ public:
     // Returns the result of the query. Not from a job!
     decltype( result.get() ) get() { return result.get(); }
 
+    // Returns the jobs of a query which only added jobs with JobsBuilder::add_free_job(). Skips the reserved job
+    std::vector<sptr<BasicJob>> free_jobs() const {
+        if ( jobs.empty() )
+            return {};
+        return std::vector<sptr<BasicJob>>( ++jobs.begin(), jobs.end() );
+    }
+
     friend class GlobalCtx;
 };
 
@@ -152,6 +159,15 @@ public:
         return *this;
     }
 
+    // Add a new job body which is taken by free workers. The first job of a query is only run by the caller when it
+    // waits for the query, so an empty job is reserved for the caller before the first free job
+    template <typename R>
+    JobsBuilder &add_free_job( std::function<R( Worker &w_ctx )> fn ) {
+        if ( jobs.empty() )
+            add_job<R>( []( Worker & ) { return R(); } );
+        return add_job<R>( fn );
+    }
+
     // Switch the context for all following jobs. Already created jobs will have the old context. This will not change
     // the query signature!
     void switch_context( sptr<UnitCtx> &new_ctx ) { ctx = new_ctx; }
@@ -57,8 +57,7 @@ struct MessageInfo {
             : MessageInfo( t.file, t.line, t.line, t.column, t.length, message_idx, color ) {}
     // This constructor in defined in libpushc/src/Expression.cpp
     MessageInfo( const AstNode &expr, u32 message_idx = 0, FmtStr::Color color = FmtStr::Color::Blue );
-    MessageInfo( const PosInfo &po, u32 message_idx = 0, FmtStr::Color color = FmtStr::Color::Blue )
-            : MessageInfo( po.file, po.line, po.line, po.column, po.length, message_idx, color ) {}
+    MessageInfo( const PosInfo &po, u32 message_idx = 0, FmtStr::Color color = FmtStr::Color::Blue );
 
     bool operator<( const MessageInfo &other ) const {
         return ( file == other.file ? line_begin < other.line_begin : file < other.file );
@@ -157,3 +156,10 @@ FmtStr get_message( sptr<Worker> w_ctx, const MessageInfo &message, const std::v
 
 // Prints
 void print_msg_to_stdout( FmtStr str );
+
+// A formatted message which is printed later (see Worker::message_buffer)
+struct DeferredMessage {
+    MessageType type;
+    MessageInfo info;
+    FmtStr str;
+};
@@ -61,6 +61,11 @@ enum class PrefType {
     debug_symbols, // bool
 
     input_source, // string
+    pretokenize_input, // tokenize whole files before parsing; bool
+    lexer_chunk_size, // bytes per job of the parallel lexer, 0 disables it; size_t
+    parallel_parsing, // parse top-level items of pretokenized files and run AST passes on them as separate jobs; bool
+    ast_cache_dir, // directory of the binary AST cache, empty disables the cache; string
+    time_passes, // measure the time and memory usage of each compiler stage; bool
 
     lto, // Link-Time Optimization; bool
 
@@ -71,5 +76,10 @@ enum class PrefType {
 // Sets the default initial prefs
 inline void set_default_preferences( std::map<PrefType, std::unique_ptr<PrefValue>> &prefs ) {
     prefs[PrefType::input_source] = std::make_unique<StringSV>( "file" );
+    prefs[PrefType::pretokenize_input] = std::make_unique<BoolSV>( true );
+    prefs[PrefType::lexer_chunk_size] = std::make_unique<SizeSV>( 256 * 1024 );
+    prefs[PrefType::parallel_parsing] = std::make_unique<BoolSV>( true );
+    prefs[PrefType::ast_cache_dir] = std::make_unique<StringSV>( "" );
+    prefs[PrefType::time_passes] = std::make_unique<BoolSV>( false );
 
 }
@@ -30,6 +30,7 @@ public:
     // Context data
     size_t id; // id of this worker
     sptr<BasicJob> curr_job;
+    std::vector<DeferredMessage> *message_buffer = nullptr; // collects non-fatal messages instead of printing them
 
 
     // Basic constructor
@@ -61,8 +62,19 @@ public:
     // Call this method in a job which does access volatile resources
     void set_curr_job_volatile();
 
-    // Prints a message to the user
+    // Prints a message to the user or stores it in the message buffer
     template <MessageType MesT, typename... Args>
     constexpr void print_msg( const MessageInfo &message,
                               const std::vector<MessageInfo> &notes = std::vector<MessageInfo>(), Args... head_args );
 };
+
+// Collects the non-fatal messages of a worker in a buffer while it exists
+class MessageBufferScope {
+    Worker &w_ctx;
+
+public:
+    MessageBufferScope( Worker &w_ctx, std::vector<DeferredMessage> &buffer ) : w_ctx( w_ctx ) {
+        w_ctx.message_buffer = &buffer;
+    }
+    ~MessageBufferScope() { w_ctx.message_buffer = nullptr; }
+};
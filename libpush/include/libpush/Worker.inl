@@ -25,5 +25,10 @@ auto Worker::do_query( FuncT fn, const Args &... args ) -> decltype( auto ) {
 
 template <MessageType MesT, typename... Args>
 constexpr void Worker::print_msg( const MessageInfo &message, const std::vector<MessageInfo> &notes, Args... head_args ) {
-    g_ctx->print_msg<MesT>( shared_from_this(), message, notes, head_args... );
+    if ( message_buffer && MesT >= MessageType::error ) {
+        message_buffer->push_back(
+            DeferredMessage{ MesT, message, get_message<MesT>( shared_from_this(), message, notes, head_args... ) } );
+    } else {
+        g_ctx->print_msg<MesT>( shared_from_this(), message, notes, head_args... );
+    }
 }
@@ -14,13 +14,25 @@
 #pragma once
 #include "libpush/stdafx.h"
 #include "libpush/input/FileInput.h"
+#include "libpush/input/BufferedInput.h"
+#include "libpush/input/SourceStore.h"
 #include "libpush/UnitCtx.h"
 
+// Loads a source file from the SourceStore. The result is nullptr if the file is not available
+void load_source_file( const String &file, JobsBuilder &jb, UnitCtx &ctx );
+
+// Loads source files in separate jobs, so that free workers read them while other work continues. The results are
+// available through load_source_file()
+void prefetch_source_files( const std::vector<String> &files, JobsBuilder &jb, UnitCtx &ctx );
+
 // NOT A QUERY! Returns a source input defined by the current prefs
 sptr<SourceInput> get_source_input( sptr<String> file, Worker &w_ctx );
 
 // NOT A QUERY! Returns the path to the installed std-library path
 sptr<String> get_std_dir();
 
+// NOT A QUERY! Returns the paths of all prelude files in the std-library
+std::vector<String> get_prelude_files();
+
 // Extracts source lines from any file
 void get_source_lines( sptr<String> file, size_t line_begin, size_t line_end, JobsBuilder &jb, UnitCtx &ctx );
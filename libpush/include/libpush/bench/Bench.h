@@ -0,0 +1,58 @@
+// Copyright 2020 Erik Götzfried
+// Licensed under the Apache License, Version 2.0( the "License" );
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+#include "libpush/Base.h"
+#include "libpush/util/String.h"
+
+// Settings of a benchmark run
+struct BenchOptions {
+    size_t source_size = 256 * 1024; // approximate size of generated sources in bytes
+    size_t repetitions = 3; // the fastest repetition is reported
+    String filter; // only run cases which contain this string
+    String output_file; // additionally write results into this file
+};
+
+// Measurement of one benchmark case
+struct BenchResult {
+    String suite; // e. g. "lexer"
+    String config; // used configuration
+    String source; // kind of the measured source
+    String input; // measured implementation
+    size_t bytes = 0; // processed bytes per repetition
+    size_t items = 0; // processed tokens/nodes per repetition
+    f64 seconds = 0; // fastest repetition
+    size_t allocations = 0; // heap allocations of the fastest repetition
+    size_t peak_bytes = 0; // peak of additionally allocated heap memory in the fastest repetition
+};
+
+// Appends lines created by @param line until the source has the requested size
+String generate_source( size_t size, const std::function<String( size_t )> &line );
+
+// Measures the fastest run of @param fn over all repetitions. If @param memory is set, its allocation count and peak
+// memory are set to the values of the fastest run
+f64 measure_fastest( const BenchOptions &options, const std::function<void()> &fn, BenchResult *memory = nullptr );
+
+// Prints a result as a comma separated line
+void report( const BenchOptions &options, const BenchResult &result );
+
+// Prints a note if the time of a series of growing workloads grows super-linearly with their scale. Each result is
+// paired with the value of its scaled property
+void check_scaling( const BenchOptions &options, const std::vector<std::pair<size_t, BenchResult>> &series );
+
+// Runs all benchmarks of the executable. Defined by each benchmark target
+void run_benchmarks( const BenchOptions &options );
+
+// Runs all lexer benchmarks
+void run_lexer_benchmarks( const BenchOptions &options );
@@ -0,0 +1,97 @@
+// Copyright 2020 Erik Götzfried
+// Licensed under the Apache License, Version 2.0( the "License" );
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+#include "libpush/Base.h"
+#include "libpush/input/SourceInput.h"
+#include "libpush/input/TokenBuffer.h"
+#include "libpush/input/StreamInput.h"
+#include "libpush/Job.h"
+
+// Tokens of a part of a file
+struct LexedChunk {
+    sptr<TokenBuffer> tokens; // ends with an eof token
+    StreamInput::LevelStack end_levels; // token level state at the end of the chunk
+};
+
+// NOT A QUERY! Lexes the range [begin..end) of a source starting with the token level state @param levels
+LexedChunk lex_chunk( sptr<const String> source, size_t begin, size_t end, sptr<const LexerTables> tables,
+                      const StreamInput::LevelStack &levels, sptr<String> file, sptr<const LineTable> lines,
+                      Worker &w_ctx );
+
+// Lexes each range [boundaries[i]..boundaries[i+1]) of a source as a separate job. All chunks start speculatively
+// with the normal token level
+void lex_source_chunks( sptr<const String> source, size_t source_hash, sptr<const LexerTables> tables,
+                        sptr<String> file, sptr<const LineTable> lines, const std::vector<size_t> &boundaries,
+                        JobsBuilder &jb, UnitCtx &ctx );
+
+// Tokenizes a whole file up front and provides a cursor over the resulting token buffer
+class BufferedInput : public SourceInput {
+    sptr<const String> source;
+    sptr<TokenBuffer> buffer;
+    size_t pos = 0; // index of the next token
+    size_t previewed = 0; // amount of tokens returned by preview_token() and preview_next_token()
+
+    // Returns the token at an index or the eof token if the index is out of range
+    Token token_at( size_t idx );
+
+    // Lexes the source from @param offset on in parallel chunks
+    std::vector<LexedChunk> lex_parallel( size_t offset, size_t chunk_size );
+
+public:
+    // @param source must contain the whole content of @param file
+    BufferedInput( sptr<String> file, sptr<Worker> w_ctx, sptr<const String> source );
+
+    // Like the constructor above, but uses an existing line table of @param source
+    BufferedInput( sptr<String> file, sptr<Worker> w_ctx, sptr<const String> source, sptr<const LineTable> lines );
+
+    // Tokenizes the remaining file (from the current position on) with the new configuration. Must not be called
+    // inside of a comment or string
+    using SourceInput::configure;
+    void configure( sptr<const LexerTables> tables );
+
+    // Replaces the bytes [begin..end) of the source with @param replacement. Only the tokens around the edit are
+    // lexed again, the unchanged tokens before and after it are reused. The cursor is moved back if it was behind
+    // the first changed token
+    void apply_edit( size_t begin, size_t end, const String &replacement );
+
+    // Returns the current source content
+    sptr<const String> get_source() const { return source; }
+
+    sptr<SourceInput> open_new_file( sptr<String> file, sptr<Worker> w_ctx );
+
+    Token get_token();
+
+    Token preview_token();
+
+    Token preview_next_token();
+
+    Token preview_token_at( size_t distance );
+
+    size_t mark() { return pos; }
+
+    void reset( size_t mark ) {
+        pos = mark;
+        previewed = 0;
+    }
+
+    std::list<String> get_lines( size_t line_begin, size_t line_end, Worker &w_ctx );
+
+    // Returns the underlying token buffer
+    sptr<TokenBuffer> get_buffer() { return buffer; }
+
+    // Creates a new input over the tokens [begin..end) of this input followed by the eof token. The tokens keep their
+    // positions in the file
+    sptr<BufferedInput> slice( size_t begin, size_t end, sptr<Worker> w_ctx );
+};
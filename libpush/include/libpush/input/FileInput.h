@@ -30,4 +30,10 @@ public:
     static bool file_exists( const String &file ) {
         return fs::exists( file.to_path() ) && fs::is_regular_file( file.to_path() );
     }
+
+    // Returns the whole content of a file
+    static sptr<String> read_file( const String &file ) {
+        std::basic_ifstream<char> stream( file, std::ios_base::binary );
+        return make_shared<String>( std::istreambuf_iterator<char>( stream ), std::istreambuf_iterator<char>() );
+    }
 };
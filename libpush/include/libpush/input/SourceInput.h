@@ -17,10 +17,11 @@
 
 // Contains information about the position in the file
 struct PosInfo {
-    sptr<String> file; // The actual access goes through the SourceInput
-    size_t line = 0;
-    size_t column = 0;
-    size_t length = 0;
+    u32 file = 0; // id from SourceStore::get_file_id(). The path is only resolved when a message is created
+    u32 offset = 0; // byte offset from the beginning of the file
+    u32 line = 0;
+    u32 column = 0;
+    u32 length = 0;
 };
 
 // Merge two position information objects into one
@@ -82,6 +83,7 @@ struct Token {
     size_t line = 0;
     size_t column = 0;
     size_t length = 0;
+    size_t offset = 0; // byte offset from the beginning of the file. Not part of the comparison
     String leading_ws; // contains the whitspace in front of this token
     TokenLevel tl;
 
@@ -98,6 +100,9 @@ struct Token {
         this->tl = tl;
     }
 
+    // Returns the position of this token
+    PosInfo pos_info() const;
+
     bool operator==( const Token &other ) const {
         return type == other.type && content == other.content &&
                ( file == other.file || ( file && other.file && *file == *other.file ) ) && line == other.line &&
@@ -173,19 +178,40 @@ struct TokenConfig {
     static TokenConfig get_prelude_cfg();
 };
 
-// Base class to get a token list
-class SourceInput {
-protected:
+// Serializes a configuration. Used to identify equal configurations
+std::ostream &operator<<( std::ostream &stream, const TokenConfig &cfg );
+
+// Lookup tables compiled from a TokenConfig. Immutable, so that all inputs with the same config can share them
+struct LexerTables {
     TokenConfig cfg;
+    size_t hash; // hash of the serialized config
     std::map<TokenLevel, std::unordered_map<String, Token::Type>>
         not_sticky_map; // maps not sticky tokens (for each token level)
     std::map<CharRangeType, std::unordered_set<u32>> ranges_sets; // maps to elements in char ranges
-    sptr<Worker> w_ctx;
-    sptr<String> filename;
-    size_t max_op_size; // max size of a operator (any not-sticky token)
+    size_t max_op_size = 1; // max size of a operator (any not-sticky token)
+
+    explicit LexerTables( const TokenConfig &cfg );
+
+    // Returns the token types of a level
+    const std::unordered_map<String, Token::Type> &tokens_of( TokenLevel tl ) const { return not_sticky_map.at( tl ); }
+
+    // Returns the chars of a range
+    const std::unordered_set<u32> &range( CharRangeType range ) const { return ranges_sets.at( range ); }
 
+private:
     // Adds all chars of a string to a specific char range
     void insert_in_range( const String &str, CharRangeType range );
+};
+
+// Compiles the lexer tables of a token configuration. Equal configurations share the same tables
+void compile_lexer_tables( const TokenConfig &cfg, JobsBuilder &jb, UnitCtx &ctx );
+
+// Base class to get a token list
+class SourceInput {
+protected:
+    sptr<const LexerTables> tables; // shared between all inputs with the same config
+    sptr<Worker> w_ctx;
+    sptr<String> filename;
 
     // Checks which token matches the whole string. Returns Token::Type::count if none was found
     Token::Type find_non_sticky_token( const StringSlice &str, TokenLevel tl );
@@ -200,8 +226,11 @@ public:
     }
     virtual ~SourceInput() {}
 
-    // set the TokenConfig configuration
-    virtual void configure( const TokenConfig &cfg );
+    // set the TokenConfig configuration. The lexer tables are looked up in the query cache
+    void configure( const TokenConfig &cfg );
+
+    // set precompiled lexer tables
+    virtual void configure( sptr<const LexerTables> tables );
 
     // Opens a new source input for the given file
     virtual sptr<SourceInput> open_new_file( sptr<String> file, sptr<Worker> w_ctx ) = 0;
@@ -218,6 +247,18 @@ public:
     // like preview_token but gives the next after a earlier preview
     virtual Token preview_next_token() = 0;
 
+    // Get the token @param distance tokens after the next token, but don't move the stream head forward.
+    virtual Token preview_token_at( size_t distance ) = 0;
+
+    // Returns the current position, which can be restored with reset(). Only supported by pre-tokenized inputs
+    virtual size_t mark() {
+        LOG_ERR( "This source input does not support backtracking" );
+        return 0;
+    }
+
+    // Restores a position returned by mark(). Only supported by pre-tokenized inputs
+    virtual void reset( size_t ) { LOG_ERR( "This source input does not support backtracking" ); }
+
     // Returns a list of source lines from the range line_begin..=line_end
     virtual std::list<String> get_lines( size_t line_begin, size_t line_end, Worker &w_ctx ) = 0;
 };
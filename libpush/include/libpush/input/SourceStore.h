@@ -0,0 +1,64 @@
+// Copyright 2020 Erik Götzfried
+// Licensed under the Apache License, Version 2.0( the "License" );
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+#include "libpush/Base.h"
+#include "libpush/util/String.h"
+#include "libpush/input/TokenBuffer.h"
+
+// Immutable content of a source file with its line index
+struct SourceFile {
+    sptr<const String> content;
+    sptr<const LineTable> lines;
+    size_t hash = 0; // hash of the content
+};
+
+// Process-wide store of source file buffers. Files are identified by their path and modification state, buffers by
+// their content. So every distinct file version is kept only once, however often it is used
+class SourceStore {
+    // State of a file when it was read the last time
+    struct PathEntry {
+        fs::file_time_type write_time;
+        uintmax_t size = 0;
+        sptr<const SourceFile> file;
+    };
+
+    Mutex mtx;
+    std::unordered_map<String, PathEntry> paths;
+    std::unordered_multimap<size_t, std::weak_ptr<const SourceFile>> contents; // content hash => buffers
+
+    Mutex file_id_mtx;
+    std::unordered_map<String, u32> file_ids; // maps file paths to their id
+    std::vector<sptr<String>> file_paths{ nullptr }; // maps file ids to their path. The id 0 means no file
+
+public:
+    // Returns the current version of a file or nullptr if it does not exist. The file is only read again if it was
+    // modified since the last call
+    sptr<const SourceFile> load( const String &path );
+
+    // Returns a buffer with the given content. Reuses an existing buffer with equal content
+    sptr<const SourceFile> add( sptr<const String> content );
+
+    // Returns the amount of distinct buffers which are still in use
+    size_t buffer_count();
+
+    // Returns the unique id of a file path. The id is created if the file was not known before. Returns 0 for nullptr
+    u32 get_file_id( const sptr<String> &file );
+
+    // Returns the path of a file id or nullptr for the id 0
+    sptr<String> get_file_path( u32 file_id );
+
+    // Returns the process-wide store
+    static sptr<SourceStore> get_global();
+};
@@ -17,19 +17,23 @@
 
 // Provides token input from any stream
 class StreamInput : public SourceInput {
+public:
+    using LevelStack = std::stack<std::pair<String, TokenLevel>>; // Level begin token -> level class
+
 protected:
     sptr<std::basic_istream<char>> stream;
 
 private:
     bool checked_bom = false; // already checked for BOM
 
-    std::stack<std::pair<String, TokenLevel>> level_stack; // Level begin token -> level class
+    LevelStack level_stack;
     size_t curr_line = 1;
     size_t curr_column = 1;
+    size_t curr_offset = 0; // byte offset of the next unprocessed char
 
     bool next_ws_is_not_special = false; // to stop infinit loops
     String putback_buffer; // contains last chars which where not used
-    std::queue<Token> back_buffer; // contains token which have only been previewed
+    std::deque<Token> back_buffer; // contains token which have only been previewed
 
     // Load the next characters from the stream. Returns false if eof reached or failed
     bool load_next_chars( String &buffer, size_t count = 1 );
@@ -48,5 +52,13 @@ public:
 
     Token preview_next_token();
 
+    Token preview_token_at( size_t distance );
+
     std::list<String> get_lines( size_t line_begin, size_t line_end, Worker &w_ctx );
+
+    // Returns the current token level state
+    const LevelStack &get_level_stack() const { return level_stack; }
+
+    // Continues lexing with a previously returned token level state
+    void set_level_stack( const LevelStack &levels ) { level_stack = levels; }
 };
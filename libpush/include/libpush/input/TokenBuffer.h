@@ -0,0 +1,141 @@
+// Copyright 2020 Erik Götzfried
+// Licensed under the Apache License, Version 2.0( the "License" );
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+#include "libpush/Base.h"
+#include "libpush/input/SourceInput.h"
+#include "libpush/util/StringInterner.h"
+
+// Small token representation. All variable-length data is interned and positions are resolved through a TokenBuffer
+struct CompactToken {
+    u32 file = 0; // file id from GlobalCtx::get_file_id()
+    u32 offset = 0; // byte offset from the beginning of the file
+    u32 length = 0; // length in code points
+    u32 content = StringInterner::EMPTY_ID; // interned content
+    u32 leading_ws = StringInterner::EMPTY_ID; // interned whitespace in front of this token
+    u16 type_level = 0; // Token::Type in the low byte and TokenLevel in the high byte
+
+    Token::Type type() const { return static_cast<Token::Type>( type_level & 0xFF ); }
+    TokenLevel level() const { return static_cast<TokenLevel>( type_level >> 8 ); }
+
+    // Packs a token type and level into one value
+    static u16 pack_type_level( Token::Type type, TokenLevel tl ) {
+        return static_cast<u16>( static_cast<u16>( type ) | ( static_cast<u16>( tl ) << 8 ) );
+    }
+};
+static_assert( sizeof( CompactToken ) <= 24, "CompactToken should not grow" );
+
+// Maps byte offsets to lines. Newlines are detected like in the lexer ("\n", "\r\n" or "\r")
+class LineTable {
+    std::vector<u32> line_begins; // byte offset of the first char in every line
+
+public:
+    LineTable() {}
+    explicit LineTable( const String &source );
+
+    // Returns the amount of lines
+    size_t line_count() const { return line_begins.size(); }
+
+    // Returns the line (beginning at 1) which contains the byte offset
+    size_t line_of( size_t offset ) const;
+
+    // Returns the byte offset of the first char in a line (beginning at 1)
+    size_t line_begin( size_t line ) const;
+
+    // Returns the content of a line (beginning at 1) without the trailing newline
+    StringSlice get_line( size_t line, const String &source ) const;
+
+    // Returns the existing lines in the range line_begin..=line_end (beginning at 1)
+    std::list<String> get_lines( size_t line_begin, size_t line_end, const String &source ) const;
+};
+
+// Stores all tokens of one file as a structure of arrays. The last token is always the eof token
+class TokenBuffer {
+    u32 file_id;
+    sptr<String> file;
+    sptr<const String> source;
+    sptr<const LineTable> lines; // may be shared between buffers of the same file
+    sptr<StringInterner> interner;
+
+    std::vector<u32> offsets;
+    std::vector<u32> lengths;
+    std::vector<u32> contents;
+    std::vector<u32> leading_ws;
+    std::vector<u16> type_levels;
+
+public:
+    // @param source must contain the whole file content which is lexed into this buffer
+    TokenBuffer( u32 file_id, sptr<String> file, sptr<const String> source, sptr<StringInterner> interner );
+
+    // Like the constructor above, but uses an existing line table of @param source
+    TokenBuffer( u32 file_id, sptr<String> file, sptr<const String> source, sptr<const LineTable> lines,
+                 sptr<StringInterner> interner );
+
+    // Appends a token to the end of the buffer
+    void push_back( const Token &token );
+
+    // Appends the tokens [begin..end) of another buffer which uses the same interner. Their offsets are moved by
+    // @param offset_shift bytes
+    void append( const TokenBuffer &other, size_t begin, size_t end, i64 offset_shift = 0 );
+
+    // Inserts whitespace in front of the leading whitespace of a token
+    void prepend_leading_ws( size_t idx, const String &ws );
+
+    // Removes all tokens from @param size onwards
+    void truncate( size_t size );
+
+    // Returns the amount of stored tokens
+    size_t size() const { return offsets.size(); }
+
+    // Returns the compact representation of a token
+    CompactToken get( size_t idx ) const;
+
+    // Returns the type of a token
+    Token::Type type( size_t idx ) const { return static_cast<Token::Type>( type_levels[idx] & 0xFF ); }
+
+    // Returns the level of a token
+    TokenLevel level( size_t idx ) const { return static_cast<TokenLevel>( type_levels[idx] >> 8 ); }
+
+    // Returns the byte offset of a token
+    size_t offset( size_t idx ) const { return offsets[idx]; }
+
+    // Returns the index of the first token which begins at or after a byte offset
+    size_t find_offset( size_t offset ) const {
+        return std::lower_bound( offsets.begin(), offsets.end(), offset ) - offsets.begin();
+    }
+
+    // Returns the content of a token
+    const String &content( size_t idx ) const { return interner->get( contents[idx] ); }
+
+    // Returns the whitespace in front of a token
+    const String &leading_whitespace( size_t idx ) const { return interner->get( leading_ws[idx] ); }
+
+    // Returns the line of a token (beginning at 1)
+    size_t line( size_t idx ) const { return lines->line_of( offsets[idx] ); }
+
+    // Returns the column of a token (beginning at 1)
+    size_t column( size_t idx ) const;
+
+    // Expands a token into the regular token representation
+    Token to_token( size_t idx ) const;
+
+    u32 get_file_id() const { return file_id; }
+    sptr<String> get_file() const { return file; }
+    sptr<const String> get_source() const { return source; }
+    const LineTable &get_line_table() const { return *lines; }
+    sptr<const LineTable> get_shared_line_table() const { return lines; }
+
+    // Lexes all tokens from @param input into a new buffer. @param source must be the content which @param input reads
+    static sptr<TokenBuffer> lex( SourceInput &input, sptr<const String> source, Worker &w_ctx );
+};
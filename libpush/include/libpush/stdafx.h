@@ -15,12 +15,14 @@
 
 #include <iostream>
 #include <string>
+#include <cstring>
 #include <list>
 #include <vector>
 #include <set>
 #include <array>
 #include <stack>
 #include <queue>
+#include <deque>
 #include <map>
 #include <unordered_map>
 #include <unordered_set>
@@ -34,6 +36,7 @@
 #include <sstream>
 #include <fstream>
 #include <filesystem>
+#include <optional>
 
 
 #ifdef _WIN32 // Windows
@@ -0,0 +1,74 @@
+// Copyright 2020 Erik Götzfried
+// Licensed under the Apache License, Version 2.0( the "License" );
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "libpush/Base.h"
+#include "libpush/util/String.h"
+
+// Resource usage of a compiler stage, accumulated over all its runs
+struct PassStats {
+    String name; // name of the stage
+    size_t runs = 0; // how often the stage was run
+    f64 wall_seconds = 0; // elapsed real time
+    f64 cpu_seconds = 0; // CPU time of the whole process while the stage ran
+    size_t nodes = 0; // processed items, e. g. tokens, AST nodes or MIR operations
+    size_t allocations = 0; // heap allocations of the process while the stage ran
+    size_t peak_bytes = 0; // highest heap usage above the usage at the start of a run
+};
+
+// Heap usage of the process. Only counted if the executable links the libpush_heap_stats objects (util/HeapStats.cpp),
+// which forward the global allocation functions to count_allocation() and count_deallocation()
+struct HeapStats {
+    size_t allocations = 0; // total count of allocations
+    size_t bytes = 0; // currently allocated bytes
+    size_t peak_bytes = 0; // highest value of bytes since the start of the process
+};
+
+// Records an allocation of the process
+void count_allocation( size_t size );
+// Records a deallocation of the process
+void count_deallocation( size_t size );
+// Returns whether allocations are counted at all
+bool heap_stats_available();
+// Returns the current heap usage of the process
+HeapStats get_heap_stats();
+// Starts a new peak measurement at the current heap usage, which is returned. Don't use it while a PassTimer runs
+size_t reset_heap_peak();
+// Returns the highest heap usage since the last reset_heap_peak() or start of a PassTimer
+size_t get_heap_peak();
+
+// Measures a run of a compiler stage while it is in scope and adds it to the stats of the global context if
+// PrefType::time_passes is set. Nested stages are included in the values of the outer ones. Peak memory is only exact
+// if no other stage runs concurrently
+class PassTimer {
+    GlobalCtx *g_ctx = nullptr; // nullptr if disabled
+    PassStats run;
+    std::chrono::steady_clock::time_point start_time;
+    std::clock_t start_cpu = 0;
+    size_t start_allocations = 0;
+    size_t start_bytes = 0;
+    size_t outer_peak_bytes = 0; // peak of an enclosing stage, which is restored at the end of this run
+
+public:
+    PassTimer( Worker &w_ctx, const String &name );
+    ~PassTimer();
+
+    PassTimer( const PassTimer &other ) = delete;
+    PassTimer &operator=( const PassTimer &other ) = delete;
+
+    // Returns whether the stage is measured. Use it to skip expensive node counting
+    bool enabled() const { return g_ctx != nullptr; }
+
+    // Adds processed items to this run
+    void add_nodes( size_t count ) { run.nodes += count; }
+};
@@ -0,0 +1,87 @@
+// Copyright 2020 Erik Götzfried
+// Licensed under the Apache License, Version 2.0( the "License" );
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+#include "libpush/Base.h"
+#include "libpush/util/String.h"
+
+// Maps every distinct string to a unique 32 bit id. Thread-safe. Reading an interned string does not lock.
+class StringInterner {
+    constexpr static size_t CHUNK_BITS = 14;
+    constexpr static size_t CHUNK_SIZE = 1 << CHUNK_BITS;
+    constexpr static size_t MAX_CHUNKS = 1 << 14;
+    constexpr static size_t SHARD_COUNT = 16;
+
+    // Part of the lookup map. Sharded to reduce lock contention
+    struct Shard {
+        Mutex mtx;
+        std::unordered_map<String, u32> ids;
+    };
+    std::array<Shard, SHARD_COUNT> shards;
+
+    Mutex alloc_mtx; // used to create new ids
+    std::atomic<u32> next_id;
+    std::array<std::atomic<String *>, MAX_CHUNKS> chunks; // strings are never moved after publication
+
+public:
+    // The empty string always has this id
+    constexpr static u32 EMPTY_ID = 0;
+
+    StringInterner();
+    ~StringInterner();
+
+    // Returns the id of a string and adds it if it is not interned yet
+    u32 intern( const String &str );
+
+    // Returns the string of an id. The reference stays valid as long as the interner exists
+    const String &get( u32 id ) const;
+
+    // Returns the amount of interned strings
+    size_t size() const { return next_id.load( std::memory_order_acquire ); }
+
+    // Returns the process-wide interner
+    static sptr<StringInterner> get_global();
+};
+
+// String which is stored in the global interner. Comparisons only compare the ids
+class InternedString {
+    u32 id = StringInterner::EMPTY_ID;
+
+public:
+    InternedString() {}
+    explicit InternedString( const String &str ) : id( StringInterner::get_global()->intern( str ) ) {}
+    explicit InternedString( const char *str ) : InternedString( String( str ) ) {}
+
+    // Returns the interned id
+    u32 get_id() const { return id; }
+
+    // Returns the string value
+    const String &str() const { return StringInterner::get_global()->get( id ); }
+    operator const String &() const { return str(); }
+
+    bool empty() const { return id == StringInterner::EMPTY_ID; }
+
+    bool operator==( const InternedString &other ) const { return id == other.id; }
+    bool operator!=( const InternedString &other ) const { return id != other.id; }
+    bool operator<( const InternedString &other ) const { return id < other.id; }
+};
+
+namespace std {
+// Creates a hash from an InternedString
+template <>
+struct hash<InternedString> {
+public:
+    size_t operator()( const InternedString &str ) const noexcept { return hash<u32>{}( str.get_id() ); }
+};
+} // namespace std
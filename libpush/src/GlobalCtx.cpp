@@ -16,6 +16,7 @@
 #include "libpush/Worker.h"
 #include "libpush/Message.h"
 #include "libpush/UnitCtx.h"
+#include "libpush/input/SourceStore.h"
 
 
 sptr<Worker> GlobalCtx::setup( size_t thread_count, size_t cache_map_reserve ) {
@@ -89,6 +90,35 @@ void GlobalCtx::abort_compilation() {
     abort_new_jobs = true;
 }
 
+u32 GlobalCtx::get_file_id( const sptr<String> &file ) {
+    return SourceStore::get_global()->get_file_id( file );
+}
+
+sptr<String> GlobalCtx::get_file_path( u32 file_id ) {
+    return SourceStore::get_global()->get_file_path( file_id );
+}
+
+void GlobalCtx::add_pass_stats( const PassStats &run ) {
+    Lock lock( pass_stats_mtx );
+    auto itr = std::find_if( pass_stats.begin(), pass_stats.end(),
+                             [&run]( const PassStats &stats ) { return stats.name == run.name; } );
+    if ( itr == pass_stats.end() ) {
+        pass_stats.push_back( run );
+        return;
+    }
+    itr->runs += run.runs;
+    itr->wall_seconds += run.wall_seconds;
+    itr->cpu_seconds += run.cpu_seconds;
+    itr->nodes += run.nodes;
+    itr->allocations += run.allocations;
+    itr->peak_bytes = std::max( itr->peak_bytes, run.peak_bytes );
+}
+
+std::vector<PassStats> GlobalCtx::get_pass_stats() {
+    Lock lock( pass_stats_mtx );
+    return pass_stats;
+}
+
 bool requires_run( QueryCacheHead &head ) {
     if ( head.state >= QueryCacheHead::STATE_GREEN ) {
         return false;
@@ -16,10 +16,15 @@
 #include "libpush/GlobalCtx.h"
 #include "libpush/basic_queries/FileQueries.h"
 #include "libpush/UnitCtx.h"
+#include "libpush/input/SourceStore.h"
 #include "libpush/GlobalCtx.inl"
 
 #include "libpush/util/FunctionHash.inl"
 
+MessageInfo::MessageInfo( const PosInfo &po, u32 message_idx, FmtStr::Color color )
+        : MessageInfo( SourceStore::get_global()->get_file_path( po.file ), po.line, po.line, po.column, po.length,
+                       message_idx, color ) {}
+
 // Replaces tabs with spaces
 void ws_format_line( String &line ) {
     String tab_replace;
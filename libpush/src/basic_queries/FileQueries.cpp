@@ -16,6 +16,23 @@
 
 #include "libpush/Worker.inl"
 #include "libpush/Message.inl"
+#include "libpush/Job.inl"
+#include "libpush/util/FunctionHash.inl"
+
+void load_source_file( const String &file, JobsBuilder &jb, UnitCtx &ctx ) {
+    jb.add_job<sptr<const SourceFile>>( [file]( Worker &w_ctx ) -> sptr<const SourceFile> {
+        w_ctx.set_curr_job_volatile(); // the file may change between builds
+        if ( w_ctx.global_ctx()->get_pref<StringSV>( PrefType::input_source ) != "file" )
+            return nullptr;
+        return SourceStore::get_global()->load( file );
+    } );
+}
+
+void prefetch_source_files( const std::vector<String> &files, JobsBuilder &jb, UnitCtx &ctx ) {
+    for ( auto &file : files ) {
+        jb.add_free_job<void>( [file]( Worker &w_ctx ) { w_ctx.do_query( load_source_file, file ); } );
+    }
+}
 
 sptr<SourceInput> get_source_input( sptr<String> file, Worker &w_ctx ) {
     sptr<SourceInput> source_input;
@@ -24,7 +41,13 @@ sptr<SourceInput> get_source_input( sptr<String> file, Worker &w_ctx ) {
         if ( !FileInput::file_exists( *file ) ) {
             w_ctx.print_msg<MessageType::ferr_file_not_found>( MessageInfo(), {}, *file );
         }
-        source_input = make_shared<FileInput>( file, w_ctx.shared_from_this() );
+        if ( w_ctx.global_ctx()->get_pref<BoolSV>( PrefType::pretokenize_input ) ) {
+            auto source_file = w_ctx.do_query( load_source_file, *file )->jobs.back()->to<sptr<const SourceFile>>();
+            source_input = make_shared<BufferedInput>( file, w_ctx.shared_from_this(), source_file->content,
+                                                       source_file->lines );
+        } else {
+            source_input = make_shared<FileInput>( file, w_ctx.shared_from_this() );
+        }
     } else if ( input_pref != "debug" ) {
         LOG_ERR( "Unknown input type pref." );
         w_ctx.print_msg<MessageType::err_unknown_source_input_pref>( MessageInfo(), {}, input_pref, *file );
@@ -37,11 +60,29 @@ sptr<String> get_std_dir() {
     return make_shared<String>( CMAKE_PROJECT_ROOT "/libstd" );
 }
 
+std::vector<String> get_prelude_files() {
+    std::vector<String> files;
+    auto prelude_dir = get_std_dir()->to_path() / "prelude";
+    if ( fs::is_directory( prelude_dir ) ) {
+        for ( auto &entry : fs::directory_iterator( prelude_dir ) ) {
+            if ( fs::is_regular_file( entry.path() ) && entry.path().extension() == ".push" )
+                files.push_back( entry.path().string() );
+        }
+    }
+    std::sort( files.begin(), files.end() );
+    return files;
+}
+
 void get_source_lines( sptr<String> file, size_t line_begin, size_t line_end, JobsBuilder &jb, UnitCtx &ctx ) {
-    jb.add_job<std::list<String>>( [&, file, line_begin, line_end]( Worker &w_ctx ) {
-        auto source = get_source_input( file, w_ctx );
-        if ( !source )
+    jb.add_job<std::list<String>>( [file, line_begin, line_end]( Worker &w_ctx ) {
+        // Uses the cached line index instead of rescanning the file
+        auto source_file = w_ctx.do_query( load_source_file, *file )->jobs.back()->to<sptr<const SourceFile>>();
+        if ( !source_file )
             return std::list<String>(); // lines not available
-        return source->get_lines( line_begin, line_end, w_ctx );
+        if ( line_begin == 0 || line_end > source_file->lines->line_count() ) {
+            w_ctx.print_msg<MessageType::err_unexpected_eof_at_line_query>(
+                MessageInfo(), {}, file, source_file->lines->line_count(), line_begin, line_end );
+        }
+        return source_file->lines->get_lines( line_begin, line_end, *source_file->content );
     } );
 }
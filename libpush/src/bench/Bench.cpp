@@ -0,0 +1,116 @@
+// Copyright 2020 Erik Götzfried
+// Licensed under the Apache License, Version 2.0( the "License" );
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "libpush/stdafx.h"
+#include "libpush/bench/Bench.h"
+#include "libpush/util/PassStats.h"
+
+// Header of the result lines
+constexpr const char *RESULT_HEADER =
+    "suite,config,source,input,bytes,items,seconds,mb_per_s,items_per_s,allocations,peak_kb";
+
+String generate_source( size_t size, const std::function<String( size_t )> &line ) {
+    String source;
+    for ( size_t i = 0; source.size() < size; i++ )
+        source += line( i );
+    return source;
+}
+
+f64 measure_fastest( const BenchOptions &options, const std::function<void()> &fn, BenchResult *memory ) {
+    f64 fastest = std::numeric_limits<f64>::max();
+    for ( size_t i = 0; i < std::max<size_t>( 1, options.repetitions ); i++ ) {
+        size_t start_allocations = get_heap_stats().allocations;
+        size_t start_bytes = reset_heap_peak();
+
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+
+        f64 duration = std::chrono::duration<f64>( end - start ).count();
+        if ( duration < fastest && memory ) {
+            memory->allocations = get_heap_stats().allocations - start_allocations;
+            memory->peak_bytes = get_heap_peak() - start_bytes;
+        }
+        fastest = std::min( fastest, duration );
+    }
+    return fastest;
+}
+
+void report( const BenchOptions &options, const BenchResult &result ) {
+    std::stringstream ss;
+    f64 seconds = std::max( result.seconds, 1e-9 );
+    ss << result.suite << ',' << result.config << ',' << result.source << ',' << result.input << ',' << result.bytes
+       << ',' << result.items << ',' << std::fixed << std::setprecision( 6 ) << result.seconds << ','
+       << std::setprecision( 3 ) << result.bytes / seconds / ( 1024. * 1024. ) << ',' << std::setprecision( 0 )
+       << result.items / seconds << ',' << result.allocations << ',' << result.peak_bytes / 1024;
+
+    std::cout << ss.str() << std::endl;
+    if ( !options.output_file.empty() ) {
+        std::ofstream file( options.output_file, std::ios_base::app );
+        file << ss.str() << '\n';
+    }
+}
+
+void check_scaling( const BenchOptions &options, const std::vector<std::pair<size_t, BenchResult>> &series ) {
+    // Allow some noise and cache effects before a series is reported
+    constexpr f64 tolerance = 2.0;
+    if ( series.size() < 2 || series.front().first == 0 || series.front().second.seconds <= 0 )
+        return;
+    auto &first = series.front();
+    auto &last = series.back();
+    f64 scale_growth = last.first / f64( first.first );
+    f64 time_growth = last.second.seconds / first.second.seconds;
+    if ( time_growth > scale_growth * tolerance ) {
+        std::stringstream ss;
+        ss << "# super-linear scaling: " << last.second.suite << '/' << last.second.config << '/'
+           << last.second.source << '/' << last.second.input << " needs " << std::fixed << std::setprecision( 1 )
+           << time_growth << "x the time for " << scale_growth << "x the scale";
+        std::cout << ss.str() << std::endl;
+        if ( !options.output_file.empty() ) {
+            std::ofstream file( options.output_file, std::ios_base::app );
+            file << ss.str() << '\n';
+        }
+    }
+}
+
+int main( int argc, char **argv ) {
+    BenchOptions options;
+    for ( int i = 1; i < argc; i++ ) {
+        String arg = argv[i];
+        if ( arg == "--size-kb" && i + 1 < argc ) {
+            options.source_size = std::stoull( argv[++i] ) * 1024;
+        } else if ( arg == "--repeat" && i + 1 < argc ) {
+            options.repetitions = std::stoull( argv[++i] );
+        } else if ( arg == "--filter" && i + 1 < argc ) {
+            options.filter = argv[++i];
+        } else if ( arg == "--output" && i + 1 < argc ) {
+            options.output_file = argv[++i];
+        } else {
+            std::cout << "Usage: " << argv[0]
+                      << " [--size-kb <size>] [--repeat <count>] [--filter <text>] [--output <csv file>]\n"
+                         "Results are printed as comma separated lines after the header line \""
+                      << RESULT_HEADER << "\"" << std::endl;
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if ( !options.output_file.empty() ) {
+        std::ofstream file( options.output_file );
+        file << RESULT_HEADER << '\n';
+    }
+    std::cout << RESULT_HEADER << std::endl;
+
+    run_benchmarks( options );
+    return 0;
+}
@@ -0,0 +1,130 @@
+// Copyright 2020 Erik Götzfried
+// Licensed under the Apache License, Version 2.0( the "License" );
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "libpush/stdafx.h"
+#include "libpush/bench/Bench.h"
+#include "libpush/input/FileInput.h"
+#include "libpush/input/StringInput.h"
+#include "libpush/input/BufferedInput.h"
+#include "libpush/GlobalCtx.h"
+
+#include "libpush/Worker.inl"
+#include "libpush/Job.inl"
+#include "libpush/util/FunctionHash.inl"
+
+// Returns all generated source kinds
+static std::vector<std::pair<String, String>> generate_sources( size_t size ) {
+    std::vector<std::pair<String, String>> sources;
+    sources.emplace_back( "identifiers", generate_source( size, []( size_t i ) {
+                              return "let ident_" + to_string( i ) + " = other_" + to_string( i * 7 % 1000 ) +
+                                     " + call_" + to_string( i % 97 ) + "( arg_a, arg_b, 42 );\n";
+                          } ) );
+    sources.emplace_back( "comments", generate_source( size, []( size_t i ) {
+                              return "// line comment " + to_string( i ) + " which contains a few more words\n" +
+                                     "/* block comment with some text */ value_" + to_string( i ) + ";\n";
+                          } ) );
+    sources.emplace_back( "strings", generate_source( size, []( size_t i ) {
+                              return "print( \"string literal " + to_string( i ) +
+                                     " with \\\"escaped\\\" chars\\n\", \"second string\" );\n";
+                          } ) );
+    sources.emplace_back( "nested_comments", generate_source( size, []( size_t i ) {
+                              return "/* depth 1 /* depth 2 /* depth 3 /* depth 4 " + to_string( i ) +
+                                     " */ */ */ */ code_" + to_string( i ) + ";\n";
+                          } ) );
+    return sources;
+}
+
+// Returns the prelude configuration extended by the operators and keywords of libstd/prelude/push.push
+static TokenConfig get_push_cfg() {
+    auto cfg = TokenConfig::get_prelude_cfg();
+    for ( auto &op : { ".", "::", "!", "$", "~", "-", "+", "++", "--", "&", ":", "*", "/", "%", "'", "|", "<<", ">",
+                       "..", "..=", "<", "<=", ">=", "==", "!=", "&&", "||", "=", "+=", "-=", "*=", "/=", "%=", "&=",
+                       "'=", "|=", "<<=", ">>=", ":=", "=>" } )
+        cfg.operators.push_back( op );
+    for ( auto &keyword : { "self", "Self", "mod", "unsafe", "mut", "type_of", "as", "in", "decl", "pub", "struct",
+                            "trait", "impl", "for", "use", "let", "if", "else", "while", "until", "do", "loop",
+                            "match" } )
+        cfg.keywords.push_back( keyword );
+    return cfg;
+}
+
+// Reads all tokens of an input and returns their count
+static size_t count_tokens( SourceInput &input ) {
+    size_t count = 0;
+    while ( input.get_token().type != Token::Type::eof )
+        count++;
+    return count;
+}
+
+void run_lexer_benchmarks( const BenchOptions &options ) {
+    auto g_ctx = make_shared<GlobalCtx>();
+    auto w_ctx = g_ctx->setup( 1, 0 );
+    g_ctx->set_pref<SizeSV>( PrefType::lexer_chunk_size, 0 ); // measure sequential lexing
+
+    std::vector<std::pair<String, TokenConfig>> configs;
+    configs.emplace_back( "prelude", TokenConfig::get_prelude_cfg() );
+    configs.emplace_back( "push", get_push_cfg() );
+
+    // Sources are written into files to measure the file input
+    auto dir = fs::temp_directory_path() / "push_bench";
+    fs::create_directories( dir );
+    auto sources = generate_sources( options.source_size );
+    std::vector<sptr<String>> files;
+    for ( auto &source : sources ) {
+        auto path = dir / ( source.first + ".push" );
+        std::ofstream( path, std::ios_base::binary ) << source.second;
+        files.push_back( make_shared<String>( path.string() ) );
+    }
+
+    for ( auto &config : configs ) {
+        auto tables =
+            w_ctx->do_query( compile_lexer_tables, config.second )->jobs.back()->to<sptr<const LexerTables>>();
+        for ( size_t i = 0; i < sources.size(); i++ ) {
+            auto file = files[i];
+            auto content = make_shared<const String>( sources[i].second );
+            BenchResult result;
+            result.suite = "lexer";
+            result.config = config.first;
+            result.source = sources[i].first;
+            result.bytes = content->size();
+
+            auto run_case = [&]( const String &input_name, const std::function<sptr<SourceInput>()> &create_input ) {
+                String name = result.suite + "/" + result.config + "/" + result.source + "/" + input_name;
+                if ( !options.filter.empty() && name.find( options.filter ) == String::npos )
+                    return;
+                result.input = input_name;
+                result.seconds = measure_fastest(
+                    options,
+                    [&]() {
+                        auto input = create_input();
+                        input->configure( tables );
+                        result.items = count_tokens( *input );
+                    },
+                    &result );
+                report( options, result );
+            };
+
+            run_case( "file", [&]() { return make_shared<FileInput>( file, w_ctx ); } );
+            run_case( "string", [&]() { return make_shared<StringInput>( file, w_ctx, *content ); } );
+            run_case( "buffered", [&]() { return make_shared<BufferedInput>( file, w_ctx, content ); } );
+        }
+    }
+
+    fs::remove_all( dir );
+    g_ctx->wait_finished();
+}
+
+void run_benchmarks( const BenchOptions &options ) {
+    run_lexer_benchmarks( options );
+}
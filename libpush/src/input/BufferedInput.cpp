@@ -0,0 +1,298 @@
+// Copyright 2020 Erik Götzfried
+// Licensed under the Apache License, Version 2.0( the "License" );
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "libpush/stdafx.h"
+#include "libpush/input/BufferedInput.h"
+#include "libpush/input/StringInput.h"
+#include "libpush/input/SourceStore.h"
+#include "libpush/Worker.h"
+#include "libpush/GlobalCtx.h"
+
+#include "libpush/Worker.inl"
+#include "libpush/Message.inl"
+#include "libpush/Job.inl"
+#include "libpush/util/FunctionHash.inl"
+
+BufferedInput::BufferedInput( sptr<String> file, sptr<Worker> w_ctx, sptr<const String> source )
+        : BufferedInput( file, w_ctx, source, make_shared<LineTable>( *source ) ) {}
+
+BufferedInput::BufferedInput( sptr<String> file, sptr<Worker> w_ctx, sptr<const String> source,
+                              sptr<const LineTable> lines )
+        : SourceInput( w_ctx, file ) {
+    this->source = source;
+    buffer = make_shared<TokenBuffer>( w_ctx->global_ctx()->get_file_id( file ), file, source, lines,
+                                       w_ctx->global_ctx()->get_interner() );
+}
+
+// Returns the token level state at the beginning of a file
+StreamInput::LevelStack get_base_levels() {
+    StreamInput::LevelStack levels;
+    levels.push( std::make_pair( "", TokenLevel::normal ) );
+    return levels;
+}
+
+LexedChunk lex_chunk( sptr<const String> source, size_t begin, size_t end, sptr<const LexerTables> tables,
+                      const StreamInput::LevelStack &levels, sptr<String> file, sptr<const LineTable> lines,
+                      Worker &w_ctx ) {
+    auto &g_ctx = *w_ctx.global_ctx();
+    LexedChunk chunk;
+    chunk.tokens = make_shared<TokenBuffer>( g_ctx.get_file_id( file ), file, source, lines, g_ctx.get_interner() );
+
+    StringInput input( file, w_ctx.shared_from_this(), source->substr( begin, end - begin ) );
+    input.configure( tables );
+    input.set_level_stack( levels );
+    while ( true ) {
+        auto token = input.get_token();
+        token.offset += begin;
+        chunk.tokens->push_back( token );
+        if ( token.type == Token::Type::eof )
+            break;
+    }
+    chunk.end_levels = input.get_level_stack();
+    return chunk;
+}
+
+void lex_source_chunks( sptr<const String> source, size_t source_hash, sptr<const LexerTables> tables,
+                        sptr<String> file, sptr<const LineTable> lines, const std::vector<size_t> &boundaries,
+                        JobsBuilder &jb, UnitCtx &ctx ) {
+    for ( size_t i = 0; i + 1 < boundaries.size(); i++ ) {
+        size_t begin = boundaries[i];
+        size_t end = boundaries[i + 1];
+        jb.add_job<LexedChunk>( [source, tables, file, lines, begin, end]( Worker &w_ctx ) {
+            return lex_chunk( source, begin, end, tables, get_base_levels(), file, lines, w_ctx );
+        } );
+    }
+}
+
+void BufferedInput::configure( sptr<const LexerTables> tables ) {
+    SourceInput::configure( tables );
+
+    // Tokens which have not been consumed yet are lexed again with the new configuration
+    size_t offset = 0;
+    String leading_ws;
+    if ( pos < buffer->size() ) {
+        offset = buffer->offset( pos );
+        leading_ws = buffer->leading_whitespace( pos );
+    } else if ( pos > 0 ) {
+        return; // eof was already reached
+    }
+    buffer->truncate( pos );
+    previewed = 0;
+
+    PassTimer timer( *w_ctx, "lexing" );
+    std::vector<LexedChunk> chunks;
+    size_t chunk_size = w_ctx->global_ctx()->get_pref<SizeSV>( PrefType::lexer_chunk_size );
+    if ( chunk_size > 0 && source->size() - offset > 2 * chunk_size &&
+         tables->range( CharRangeType::ws ).count( '\n' ) > 0 ) {
+        chunks = lex_parallel( offset, chunk_size );
+    } else {
+        chunks.push_back( lex_chunk( source, offset, source->size(), tables, get_base_levels(), filename,
+                                     buffer->get_shared_line_table(), *w_ctx ) );
+    }
+
+    // Splice the chunks together. The whitespace at the end of a chunk belongs to the first token of the next one
+    for ( size_t i = 0; i < chunks.size(); i++ ) {
+        auto &tokens = *chunks[i].tokens;
+        bool is_last = i + 1 == chunks.size();
+        size_t end = is_last ? tokens.size() : tokens.size() - 1; // skip intermediate eof tokens
+        if ( end > 0 ) {
+            size_t first = buffer->size();
+            buffer->append( tokens, 0, end );
+            buffer->prepend_leading_ws( first, leading_ws );
+            leading_ws.clear();
+        }
+        if ( !is_last )
+            leading_ws += tokens.leading_whitespace( tokens.size() - 1 );
+    }
+    timer.add_nodes( buffer->size() - pos );
+}
+
+std::vector<LexedChunk> BufferedInput::lex_parallel( size_t offset, size_t chunk_size ) {
+    // Speculatively split after newlines. Most of them are not in a comment or string
+    std::vector<size_t> boundaries{ offset };
+    while ( true ) {
+        size_t split = source->find( '\n', boundaries.back() + chunk_size );
+        if ( split == String::npos || split + 1 >= source->size() )
+            break;
+        boundaries.push_back( split + 1 );
+    }
+    boundaries.push_back( source->size() );
+
+    auto jc = w_ctx->do_query( lex_source_chunks, source, std::hash<String>{}( *source ), tables, filename,
+                               buffer->get_shared_line_table(), boundaries );
+    std::vector<LexedChunk> chunks;
+    for ( auto &job : jc->jobs )
+        chunks.push_back( job->to<LexedChunk>() );
+
+    // Validate the speculative token level at each boundary and relex a chunk if it was wrong
+    auto base_levels = get_base_levels();
+    for ( size_t i = 1; i < chunks.size(); i++ ) {
+        if ( chunks[i - 1].end_levels != base_levels ) {
+            chunks[i] = lex_chunk( source, boundaries[i], boundaries[i + 1], tables, chunks[i - 1].end_levels,
+                                   filename, buffer->get_shared_line_table(), *w_ctx );
+        }
+    }
+    return chunks;
+}
+
+void BufferedInput::apply_edit( size_t begin, size_t end, const String &replacement ) {
+    if ( !tables ) {
+        LOG_ERR( "BufferedInput was used before it was configured" );
+        return;
+    } else if ( begin > end || end > source->size() ) {
+        LOG_ERR( "Edit range " + to_string( begin ) + ".." + to_string( end ) + " is outside of the source" );
+        return;
+    }
+
+    auto new_source = make_shared<String>( *source );
+    new_source->replace( begin, end - begin, replacement );
+    auto new_lines = make_shared<LineTable>( *new_source );
+    i64 shift = static_cast<i64>( replacement.size() ) - static_cast<i64>( end - begin );
+    size_t edit_end = begin + replacement.size(); // end of the edit in the new source
+
+    // Without level tokens in the normal level, every token in the normal level starts with the base level state
+    bool levels_known = tables->cfg.level_map.find( TokenLevel::normal ) == tables->cfg.level_map.end() ||
+                        tables->cfg.level_map.at( TokenLevel::normal ).empty();
+
+    // Find the last token which is not influenced by the edit. Neither the token before it may look into the edit
+    size_t restart = 0; // index of the first token which is lexed again
+    size_t restart_offset = 0;
+    String leading_ws;
+    if ( levels_known ) {
+        for ( size_t i = buffer->find_offset( begin ); i-- > 0; ) {
+            if ( buffer->offset( i ) < begin && buffer->level( i ) == TokenLevel::normal &&
+                 buffer->type( i ) != Token::Type::eof &&
+                 ( i == 0 || buffer->offset( i - 1 ) + tables->max_op_size <= begin ) ) {
+                restart = i;
+                restart_offset = buffer->offset( i );
+                leading_ws = buffer->leading_whitespace( i );
+                break;
+            }
+        }
+    }
+
+    // Lex growing windows until the new tokens synchronize with the old ones
+    LexedChunk chunk;
+    size_t sync_new = 0, sync_old = 0; // indices of the first matching tokens
+    bool synchronized = false;
+    size_t window = std::max<size_t>( 4096, 2 * ( edit_end - restart_offset ) );
+    while ( true ) {
+        size_t window_end = levels_known ? std::min( new_source->size(), restart_offset + window ) : new_source->size();
+        bool complete = window_end == new_source->size();
+        chunk = lex_chunk( new_source, restart_offset, window_end, tables, get_base_levels(), filename, new_lines,
+                           *w_ctx );
+
+        auto &tokens = *chunk.tokens;
+        for ( size_t i = 0; levels_known && i + 1 < tokens.size(); i++ ) {
+            size_t offset = tokens.offset( i );
+            if ( offset < edit_end || tokens.level( i ) != TokenLevel::normal )
+                continue;
+            if ( !complete && offset + tokens.content( i ).size() + tables->max_op_size >= window_end )
+                break; // might be cut off by the window
+            size_t old_offset = static_cast<size_t>( static_cast<i64>( offset ) - shift );
+            size_t old_idx = buffer->find_offset( old_offset );
+            if ( old_idx < buffer->size() && buffer->offset( old_idx ) == old_offset ) {
+                auto old_token = buffer->get( old_idx );
+                auto new_token = tokens.get( i );
+                if ( old_token.type_level == new_token.type_level && old_token.content == new_token.content ) {
+                    sync_new = i;
+                    sync_old = old_idx;
+                    synchronized = true;
+                    break;
+                }
+            }
+        }
+        if ( synchronized || complete )
+            break;
+        window *= 2;
+    }
+
+    // Splice the unchanged prefix, the new tokens and the shifted unchanged suffix
+    auto new_buffer = make_shared<TokenBuffer>( buffer->get_file_id(), filename, new_source, new_lines,
+                                                w_ctx->global_ctx()->get_interner() );
+    new_buffer->append( *buffer, 0, restart );
+    new_buffer->append( *chunk.tokens, 0, synchronized ? sync_new + 1 : chunk.tokens->size() );
+    new_buffer->prepend_leading_ws( restart, leading_ws );
+    if ( synchronized )
+        new_buffer->append( *buffer, sync_old + 1, buffer->size(), shift );
+
+    source = new_source;
+    buffer = new_buffer;
+    pos = std::min( pos, restart );
+    previewed = 0;
+}
+
+sptr<SourceInput> BufferedInput::open_new_file( sptr<String> file, sptr<Worker> w_ctx ) {
+    auto source_file = SourceStore::get_global()->load( *file );
+    if ( !source_file )
+        return make_shared<BufferedInput>( file, w_ctx, make_shared<const String>() );
+    return make_shared<BufferedInput>( file, w_ctx, source_file->content, source_file->lines );
+}
+
+Token BufferedInput::token_at( size_t idx ) {
+    if ( buffer->size() == 0 ) {
+        LOG_ERR( "BufferedInput was used before it was configured" );
+        Token t;
+        t.type = Token::Type::eof;
+        t.file = filename;
+        t.tl = TokenLevel::normal;
+        return t;
+    }
+    return buffer->to_token( std::min( idx, buffer->size() - 1 ) );
+}
+
+Token BufferedInput::get_token() {
+    if ( previewed > 0 )
+        previewed--;
+    auto t = token_at( pos );
+    if ( pos + 1 < buffer->size() )
+        pos++;
+    return t;
+}
+
+Token BufferedInput::preview_token() {
+    if ( previewed == 0 )
+        previewed = 1;
+    return token_at( pos );
+}
+
+Token BufferedInput::preview_next_token() {
+    previewed++;
+    return token_at( pos + previewed - 1 );
+}
+
+Token BufferedInput::preview_token_at( size_t distance ) {
+    previewed = std::max( previewed, distance + 1 );
+    return token_at( pos + distance );
+}
+
+sptr<BufferedInput> BufferedInput::slice( size_t begin, size_t end, sptr<Worker> w_ctx ) {
+    auto result = make_shared<BufferedInput>( filename, w_ctx, source, buffer->get_shared_line_table() );
+    result->tables = tables;
+    if ( buffer->size() > 0 ) {
+        end = std::min( end, buffer->size() - 1 );
+        result->buffer->append( *buffer, std::min( begin, end ), end );
+        result->buffer->append( *buffer, buffer->size() - 1, buffer->size() ); // eof token
+    }
+    return result;
+}
+
+std::list<String> BufferedInput::get_lines( size_t line_begin, size_t line_end, Worker &w_ctx ) {
+    auto &table = buffer->get_line_table();
+    if ( line_begin == 0 || line_end > table.line_count() ) {
+        w_ctx.print_msg<MessageType::err_unexpected_eof_at_line_query>( MessageInfo(), {}, filename,
+                                                                        table.line_count(), line_begin, line_end );
+    }
+    return table.get_lines( line_begin, line_end, *source );
+}
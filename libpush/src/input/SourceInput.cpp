@@ -15,19 +15,34 @@
 #include "libpush/input/SourceInput.h"
 #include "libpush/Worker.h"
 #include "libpush/GlobalCtx.h"
+#include "libpush/input/SourceStore.h"
 
 #include "libpush/Worker.inl"
 #include "libpush/Message.inl"
+#include "libpush/Job.inl"
+#include "libpush/util/FunctionHash.inl"
 
 PosInfo merge_pos_infos( const PosInfo &left, const PosInfo &right ) {
     if ( left.file != right.file )
         LOG_ERR( "Failed to merge PosInfo, because of two different files" );
     if ( left.line != right.line )
         LOG_WARN( "Error messages over multiple lines are not implemented now" );
-    size_t left_end = left.column + left.length;
-    size_t right_end = right.column + right.length;
-    return PosInfo{ left.file, left.line, std::min<size_t>( left.column, right.column ),
-                    static_cast<size_t>( std::max( left_end, right_end ) - std::min( left.column, right.column ) ) };
+    u32 left_end = left.column + left.length;
+    u32 right_end = right.column + right.length;
+    return PosInfo{ left.file, std::min( left.offset, right.offset ), left.line, std::min( left.column, right.column ),
+                    std::max( left_end, right_end ) - std::min( left.column, right.column ) };
+}
+
+PosInfo Token::pos_info() const {
+    // Most positions are in the same file as the previous one, so the store is rarely locked
+    thread_local sptr<String> last_file;
+    thread_local u32 last_file_id = 0;
+    if ( file != last_file ) {
+        last_file_id = SourceStore::get_global()->get_file_id( file );
+        last_file = file;
+    }
+    return PosInfo{ last_file_id, static_cast<u32>( offset ), static_cast<u32>( line ), static_cast<u32>( column ),
+                    static_cast<u32>( length ) };
 }
 
 TokenConfig TokenConfig::get_prelude_cfg() {
@@ -65,12 +80,13 @@ TokenConfig TokenConfig::get_prelude_cfg() {
 }
 
 Token::Type SourceInput::find_non_sticky_token( const StringSlice &str, TokenLevel tl ) {
-    auto tt = not_sticky_map[tl].find( str );
-    if ( tt != not_sticky_map[tl].end() ) {
+    auto &tokens = tables->tokens_of( tl );
+    auto tt = tokens.find( str );
+    if ( tt != tokens.end() ) {
         return tt->second;
     } else {
-        auto tt = cfg.char_escapes.find( str );
-        return tt == cfg.char_escapes.end() ? Token::Type::count : Token::Type::escaped_char;
+        auto tt = tables->cfg.char_escapes.find( str );
+        return tt == tables->cfg.char_escapes.end() ? Token::Type::count : Token::Type::escaped_char;
     }
 }
 
@@ -83,7 +99,7 @@ std::pair<Token::Type, size_t> SourceInput::find_last_sticky_token( const String
     for ( ; offset < str.size(); offset++ ) {
         // Find the type of the first char
         expected = CharRangeType::identifier;
-        for ( auto &r : ranges_sets ) {
+        for ( auto &r : tables->ranges_sets ) {
             if ( r.second.find( str[offset] ) != r.second.end() ) {
                 expected = r.first;
                 break;
@@ -101,12 +117,12 @@ std::pair<Token::Type, size_t> SourceInput::find_last_sticky_token( const String
         bool matches = true;
         for ( size_t i = offset + 1; i < str.size(); i++ ) {
             // A special case are identifiers which may also contain opt_identifier(s)
-            if ( ranges_sets[expected].find( str[i] ) == ranges_sets[expected].end() &&
-                 ( expected != CharRangeType::identifier || ranges_sets[CharRangeType::opt_identifier].find( str[i] ) ==
-                                                                ranges_sets[CharRangeType::opt_identifier].end() ) ) {
+            auto &opt_identifiers = tables->range( CharRangeType::opt_identifier );
+            if ( tables->range( expected ).count( str[i] ) == 0 &&
+                 ( expected != CharRangeType::identifier || opt_identifiers.count( str[i] ) == 0 ) ) {
                 if ( expected == CharRangeType::identifier ) {
                     // An identifier may also be a char which is in no other range (because it's the default type)
-                    for ( auto &r : ranges_sets ) {
+                    for ( auto &r : tables->ranges_sets ) {
                         if ( r.first != CharRangeType::identifier && r.first != CharRangeType::opt_identifier &&
                              r.second.find( str[i] ) != r.second.end() ) {
                             // Found in another range => type not matching
@@ -122,7 +138,7 @@ std::pair<Token::Type, size_t> SourceInput::find_last_sticky_token( const String
             }
             if ( expected == CharRangeType::ws ) {
                 // An identifier may also be a char which is in no other range (because it's the default type)
-                for ( auto &t : not_sticky_map[tl] ) {
+                for ( auto &t : tables->tokens_of( tl ) ) {
                     if ( t.second != Token::Type::ws && str.size() >= i + t.first.size() &&
                          str.slice( i, t.first.size() ) == t.first ) {
                         // found a token which is not a whitespace
@@ -140,8 +156,8 @@ std::pair<Token::Type, size_t> SourceInput::find_last_sticky_token( const String
     // Check if matching is a keyword
     Token::Type tt;
     if ( expected == CharRangeType::identifier ) {
-        if ( std::find( cfg.keywords.begin(), cfg.keywords.end(), String( str.slice( offset ) ) ) !=
-             cfg.keywords.end() ) {
+        auto &keywords = tables->cfg.keywords;
+        if ( std::find( keywords.begin(), keywords.end(), String( str.slice( offset ) ) ) != keywords.end() ) {
             tt = Token::Type::keyword;
         } else {
             tt = Token::Type::identifier;
@@ -158,15 +174,73 @@ std::pair<Token::Type, size_t> SourceInput::find_last_sticky_token( const String
     return std::make_pair( tt, str.size() - offset );
 }
 
-void SourceInput::insert_in_range( const String &str, CharRangeType range ) {
+std::ostream &operator<<( std::ostream &stream, const TokenConfig &cfg ) {
+    auto write_pairs = [&stream]( const std::vector<std::pair<String, String>> &pairs ) {
+        stream << '{';
+        for ( auto &p : pairs )
+            stream << p.first.size() << ':' << p.first << p.second.size() << ':' << p.second;
+        stream << '}';
+    };
+    auto write_list = [&stream]( const std::vector<String> &list ) {
+        stream << '{';
+        for ( auto &s : list )
+            stream << s.size() << ':' << s;
+        stream << '}';
+    };
+
+    // Strings are prefixed by their size to avoid ambiguities
+    write_list( cfg.stat_divider );
+    write_pairs( cfg.block );
+    write_pairs( cfg.term );
+    write_pairs( cfg.array );
+    stream << '{';
+    for ( auto &lm : cfg.level_map ) {
+        stream << static_cast<int>( lm.first ) << '{';
+        for ( auto &tc : lm.second ) {
+            stream << tc.first.size() << ':' << tc.first << tc.second.begin_token.size() << ':'
+                   << tc.second.begin_token << tc.second.end_token.size() << ':' << tc.second.end_token;
+        }
+        stream << '}';
+    }
+    stream << "}{";
+    for ( auto &alo : cfg.allowed_level_overlay ) {
+        stream << alo.first.size() << ':' << alo.first;
+        write_list( alo.second );
+    }
+    stream << "}{";
+    for ( auto &ce : cfg.char_escapes )
+        stream << ce.first.size() << ':' << ce.first << ce.second.size() << ':' << ce.second;
+    stream << "}{";
+    for ( auto &cr : cfg.char_ranges ) {
+        stream << static_cast<int>( cr.first ) << '{';
+        for ( auto &subrange : cr.second )
+            stream << subrange.first << '-' << subrange.second << ',';
+        stream << '}';
+    }
+    stream << '}';
+    write_list( cfg.operators );
+    write_list( cfg.keywords );
+    return stream;
+}
+
+void LexerTables::insert_in_range( const String &str, CharRangeType range ) {
     for ( auto &s : str ) {
         ranges_sets[range].insert( s );
     }
 }
 
-void SourceInput::configure( const TokenConfig &cfg ) {
+LexerTables::LexerTables( const TokenConfig &cfg ) {
     max_op_size = 1; // min 1, to review carriage return character
     this->cfg = cfg;
+    std::stringstream ss;
+    ss << cfg;
+    hash = std::hash<std::string>{}( ss.str() );
+
+    // Every level and range exists, so that the tables can be read without modification
+    for ( size_t i = 0; i < static_cast<size_t>( TokenLevel::count ); i++ )
+        not_sticky_map[static_cast<TokenLevel>( i )];
+    for ( size_t i = 0; i < static_cast<size_t>( CharRangeType::count ); i++ )
+        ranges_sets[static_cast<CharRangeType>( i )];
 
     // Helper lambda
     auto add_sticky_token_to_all = [this]( const String &token, Token::Type tt ) {
@@ -260,3 +334,16 @@ void SourceInput::configure( const TokenConfig &cfg ) {
         insert_in_range( tc, CharRangeType::op );
     }
 }
+
+void compile_lexer_tables( const TokenConfig &cfg, JobsBuilder &jb, UnitCtx &ctx ) {
+    jb.add_job<sptr<const LexerTables>>(
+        [cfg]( Worker &w_ctx ) { return sptr<const LexerTables>( make_shared<LexerTables>( cfg ) ); } );
+}
+
+void SourceInput::configure( const TokenConfig &cfg ) {
+    configure( w_ctx->do_query( compile_lexer_tables, cfg )->jobs.back()->to<sptr<const LexerTables>>() );
+}
+
+void SourceInput::configure( sptr<const LexerTables> tables ) {
+    this->tables = tables;
+}
@@ -0,0 +1,113 @@
+// Copyright 2020 Erik Götzfried
+// Licensed under the Apache License, Version 2.0( the "License" );
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "libpush/stdafx.h"
+#include "libpush/input/SourceStore.h"
+#include "libpush/input/FileInput.h"
+
+sptr<const SourceFile> SourceStore::load( const String &path ) {
+    std::error_code ec;
+    auto fs_path = path.to_path();
+    if ( !fs::is_regular_file( fs_path, ec ) )
+        return nullptr;
+    auto write_time = fs::last_write_time( fs_path, ec );
+    auto size = fs::file_size( fs_path, ec );
+    if ( ec )
+        return nullptr;
+
+    {
+        Lock lock( mtx );
+        auto itr = paths.find( path );
+        if ( itr != paths.end() && itr->second.write_time == write_time && itr->second.size == size )
+            return itr->second.file;
+    }
+
+    // Read outside of the lock, so that multiple files can be read in parallel
+    auto file = add( FileInput::read_file( path ) );
+
+    Lock lock( mtx );
+    paths[path] = PathEntry{ write_time, size, file };
+    return file;
+}
+
+sptr<const SourceFile> SourceStore::add( sptr<const String> content ) {
+    size_t hash = std::hash<String>{}( *content );
+    {
+        Lock lock( mtx );
+        auto range = contents.equal_range( hash );
+        for ( auto itr = range.first; itr != range.second; ) {
+            auto file = itr->second.lock();
+            if ( !file ) {
+                itr = contents.erase( itr ); // buffer is not used anymore
+            } else if ( *file->content == *content ) {
+                return file;
+            } else {
+                itr++;
+            }
+        }
+    }
+
+    auto file = make_shared<SourceFile>();
+    file->content = content;
+    file->lines = make_shared<LineTable>( *content );
+    file->hash = hash;
+
+    // Another thread may have added the same content meanwhile
+    Lock lock( mtx );
+    auto range = contents.equal_range( hash );
+    for ( auto itr = range.first; itr != range.second; itr++ ) {
+        if ( auto other = itr->second.lock(); other && *other->content == *content )
+            return other;
+    }
+    contents.emplace( hash, file );
+    return file;
+}
+
+size_t SourceStore::buffer_count() {
+    Lock lock( mtx );
+    size_t count = 0;
+    for ( auto &entry : contents ) {
+        if ( !entry.second.expired() )
+            count++;
+    }
+    return count;
+}
+
+u32 SourceStore::get_file_id( const sptr<String> &file ) {
+    if ( !file )
+        return 0;
+    Lock lock( file_id_mtx );
+    auto itr = file_ids.find( *file );
+    if ( itr != file_ids.end() )
+        return itr->second;
+
+    u32 id = static_cast<u32>( file_paths.size() );
+    file_paths.push_back( file );
+    file_ids[*file] = id;
+    return id;
+}
+
+sptr<String> SourceStore::get_file_path( u32 file_id ) {
+    Lock lock( file_id_mtx );
+    if ( file_id >= file_paths.size() ) {
+        LOG_ERR( "Requested unknown file id " + to_string( file_id ) );
+        return make_shared<String>();
+    }
+    return file_paths[file_id];
+}
+
+sptr<SourceStore> SourceStore::get_global() {
+    static sptr<SourceStore> global = make_shared<SourceStore>();
+    return global;
+}
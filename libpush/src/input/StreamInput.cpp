@@ -71,6 +71,8 @@ Token StreamInput::get_token_impl( String whitespace ) {
         if ( !load_next_chars( curr, 3 ) || curr[0] != (char) 0xEF || curr[1] != (char) 0xBB ||
              curr[2] != (char) 0xBF ) { // revert chars
             putback_buffer += curr;
+        } else {
+            curr_offset = curr.size(); // skip the BOM
         }
         curr.clear();
         checked_bom = true;
@@ -81,7 +83,7 @@ Token StreamInput::get_token_impl( String whitespace ) {
     // ----------
 
     // Load next char
-    load_next_chars( curr, max_op_size );
+    load_next_chars( curr, tables->max_op_size );
 
     // Error handling
     if ( curr.empty() ) {
@@ -91,7 +93,9 @@ Token StreamInput::get_token_impl( String whitespace ) {
         t.line = curr_line;
         t.column = curr_column;
         t.length = 0;
+        t.offset = curr_offset;
         t.leading_ws = whitespace;
+        t.tl = level_stack.top().second;
         return t;
     }
 
@@ -164,11 +168,13 @@ Token StreamInput::get_token_impl( String whitespace ) {
     t.line = curr_line;
     t.column = curr_column;
     t.length = curr.length_cp();
+    t.offset = curr_offset;
     t.leading_ws = whitespace;
     t.tl = level_stack.top().second;
 
     // Count lines and columns
     if ( !is_special_ws ) {
+        curr_offset += curr.size();
         curr_line += count_newlines( curr );
         size_t last_newline_idx = curr.find_last_of( '\n' );
         if ( last_newline_idx == String::npos )
@@ -182,16 +188,20 @@ Token StreamInput::get_token_impl( String whitespace ) {
 
     // Update token level
     bool changed_level = false;
-    auto *pairs = &cfg.level_map[level_stack.top().second];
-    for ( auto &c : *pairs ) {
-        if ( c.second.begin_token == level_stack.top().first && c.second.end_token == curr ) {
-            // Found a pair which would match and end the token level
-            level_stack.pop();
-            changed_level = true;
-            break;
+    auto &cfg = tables->cfg;
+    if ( auto pairs = cfg.level_map.find( level_stack.top().second ); pairs != cfg.level_map.end() ) {
+        for ( auto &c : pairs->second ) {
+            if ( c.second.begin_token == level_stack.top().first && c.second.end_token == curr ) {
+                // Found a pair which would match and end the token level
+                level_stack.pop();
+                changed_level = true;
+                break;
+            }
         }
     }
-    std::vector<String> &alo = cfg.allowed_level_overlay[level_stack.top().first];
+    static const std::vector<String> no_overlay;
+    auto alo_itr = cfg.allowed_level_overlay.find( level_stack.top().first );
+    const std::vector<String> &alo = alo_itr != cfg.allowed_level_overlay.end() ? alo_itr->second : no_overlay;
     for ( auto &lm : cfg.level_map ) {
         if ( !changed_level ) {
             // Might be a new normal level
@@ -221,22 +231,28 @@ Token StreamInput::get_token() {
         return get_token_impl();
     } else {
         auto tmp = back_buffer.front();
-        back_buffer.pop();
+        back_buffer.pop_front();
         return tmp;
     }
 }
 
 Token StreamInput::preview_token() {
     if ( back_buffer.empty() )
-        back_buffer.push( get_token_impl() );
+        back_buffer.push_back( get_token_impl() );
     return back_buffer.front();
 }
 
 Token StreamInput::preview_next_token() {
-    back_buffer.push( get_token_impl() );
+    back_buffer.push_back( get_token_impl() );
     return back_buffer.back();
 }
 
+Token StreamInput::preview_token_at( size_t distance ) {
+    while ( back_buffer.size() <= distance )
+        back_buffer.push_back( get_token_impl() );
+    return back_buffer[distance];
+}
+
 std::list<String> StreamInput::get_lines( size_t line_begin, size_t line_end, Worker &w_ctx ) {
     size_t line_count = 1;
     std::list<String> lines;
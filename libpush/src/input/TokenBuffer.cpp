@@ -0,0 +1,158 @@
+// Copyright 2020 Erik Götzfried
+// Licensed under the Apache License, Version 2.0( the "License" );
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "libpush/stdafx.h"
+#include "libpush/input/TokenBuffer.h"
+#include "libpush/Worker.h"
+#include "libpush/GlobalCtx.h"
+
+LineTable::LineTable( const String &source ) {
+    // The UTF-8 BOM is not part of the first line
+    size_t start = source.size() >= 3 && source[0] == (char) 0xEF && source[1] == (char) 0xBB &&
+                           source[2] == (char) 0xBF
+                       ? 3
+                       : 0;
+    line_begins.push_back( static_cast<u32>( start ) );
+
+    const char *data = source.c_str();
+    const char *end = data + source.size();
+    if ( std::memchr( data + start, '\r', source.size() - start ) == nullptr ) {
+        // Only "\n" line endings. memchr() is vectorized by the standard library
+        const char *itr = data + start;
+        while ( ( itr = static_cast<const char *>( std::memchr( itr, '\n', end - itr ) ) ) != nullptr ) {
+            itr++;
+            line_begins.push_back( static_cast<u32>( itr - data ) );
+        }
+    } else {
+        for ( size_t i = start; i < source.size(); i++ ) {
+            if ( source[i] == '\n' || ( source[i] == '\r' && ( i + 1 >= source.size() || source[i + 1] != '\n' ) ) )
+                line_begins.push_back( static_cast<u32>( i + 1 ) );
+        }
+    }
+}
+
+std::list<String> LineTable::get_lines( size_t line_begin, size_t line_end, const String &source ) const {
+    std::list<String> lines;
+    for ( size_t i = std::max<size_t>( line_begin, 1 ); i <= std::min( line_end, line_count() ); i++ ) {
+        lines.push_back( get_line( i, source ) );
+    }
+    return lines;
+}
+
+size_t LineTable::line_of( size_t offset ) const {
+    return std::upper_bound( line_begins.begin(), line_begins.end(), offset ) - line_begins.begin();
+}
+
+size_t LineTable::line_begin( size_t line ) const {
+    if ( line == 0 || line > line_begins.size() ) {
+        LOG_ERR( "Requested line " + to_string( line ) + " is not in the line table" );
+        return 0;
+    }
+    return line_begins[line - 1];
+}
+
+StringSlice LineTable::get_line( size_t line, const String &source ) const {
+    size_t begin = line_begin( line );
+    size_t end = line < line_begins.size() ? line_begins[line] : source.size();
+    while ( end > begin && ( source[end - 1] == '\n' || source[end - 1] == '\r' ) )
+        end--;
+    return source.slice( begin, end - begin );
+}
+
+TokenBuffer::TokenBuffer( u32 file_id, sptr<String> file, sptr<const String> source, sptr<StringInterner> interner )
+        : TokenBuffer( file_id, file, source, make_shared<LineTable>( *source ), interner ) {}
+
+TokenBuffer::TokenBuffer( u32 file_id, sptr<String> file, sptr<const String> source, sptr<const LineTable> lines,
+                          sptr<StringInterner> interner )
+        : file_id( file_id ), file( file ), source( source ), lines( lines ), interner( interner ) {}
+
+void TokenBuffer::push_back( const Token &token ) {
+    offsets.push_back( static_cast<u32>( token.offset ) );
+    lengths.push_back( static_cast<u32>( token.length ) );
+    contents.push_back( interner->intern( token.content ) );
+    leading_ws.push_back( interner->intern( token.leading_ws ) );
+    type_levels.push_back( CompactToken::pack_type_level( token.type, token.tl ) );
+}
+
+void TokenBuffer::append( const TokenBuffer &other, size_t begin, size_t end, i64 offset_shift ) {
+    if ( other.interner != interner )
+        LOG_ERR( "Appended token buffer uses a different interner" );
+    size_t first = offsets.size();
+    offsets.insert( offsets.end(), other.offsets.begin() + begin, other.offsets.begin() + end );
+    if ( offset_shift != 0 ) {
+        for ( size_t i = first; i < offsets.size(); i++ )
+            offsets[i] = static_cast<u32>( offsets[i] + offset_shift );
+    }
+    lengths.insert( lengths.end(), other.lengths.begin() + begin, other.lengths.begin() + end );
+    contents.insert( contents.end(), other.contents.begin() + begin, other.contents.begin() + end );
+    leading_ws.insert( leading_ws.end(), other.leading_ws.begin() + begin, other.leading_ws.begin() + end );
+    type_levels.insert( type_levels.end(), other.type_levels.begin() + begin, other.type_levels.begin() + end );
+}
+
+void TokenBuffer::prepend_leading_ws( size_t idx, const String &ws ) {
+    if ( !ws.empty() )
+        leading_ws[idx] = interner->intern( ws + interner->get( leading_ws[idx] ) );
+}
+
+void TokenBuffer::truncate( size_t size ) {
+    offsets.resize( size );
+    lengths.resize( size );
+    contents.resize( size );
+    leading_ws.resize( size );
+    type_levels.resize( size );
+}
+
+CompactToken TokenBuffer::get( size_t idx ) const {
+    CompactToken t;
+    t.file = file_id;
+    t.offset = offsets[idx];
+    t.length = lengths[idx];
+    t.content = contents[idx];
+    t.leading_ws = leading_ws[idx];
+    t.type_level = type_levels[idx];
+    return t;
+}
+
+size_t TokenBuffer::column( size_t idx ) const {
+    size_t begin = lines->line_begin( line( idx ) );
+    return source->slice( begin, offsets[idx] - begin ).length_grapheme() + 1;
+}
+
+Token TokenBuffer::to_token( size_t idx ) const {
+    Token t;
+    t.type = type( idx );
+    t.content = content( idx );
+    t.file = file;
+    t.line = line( idx );
+    t.column = column( idx );
+    t.length = lengths[idx];
+    t.offset = offsets[idx];
+    t.leading_ws = interner->get( leading_ws[idx] );
+    t.tl = static_cast<TokenLevel>( type_levels[idx] >> 8 );
+    return t;
+}
+
+sptr<TokenBuffer> TokenBuffer::lex( SourceInput &input, sptr<const String> source, Worker &w_ctx ) {
+    auto &g_ctx = *w_ctx.global_ctx();
+    auto buffer = make_shared<TokenBuffer>( g_ctx.get_file_id( input.get_filename() ), input.get_filename(), source,
+                                            g_ctx.get_interner() );
+
+    while ( true ) {
+        auto token = input.get_token();
+        buffer->push_back( token );
+        if ( token.type == Token::Type::eof )
+            break;
+    }
+    return buffer;
+}
@@ -13,7 +13,14 @@
 
 #include "libpush/tests/stdafx.h"
 #include "libpush/input/FileInput.h"
+#include "libpush/input/TokenBuffer.h"
+#include "libpush/input/BufferedInput.h"
 #include "libpush/GlobalCtx.h"
+#include "libpush/basic_queries/FileQueries.h"
+
+#include "libpush/Worker.inl"
+#include "libpush/Job.inl"
+#include "libpush/util/FunctionHash.inl"
 
 namespace Catch {
 template <>
@@ -148,6 +155,255 @@ TEST_CASE( "Basic lexing", "[lexer]" ) {
     }
 }
 
+TEST_CASE( "Compact token buffer", "[lexer]" ) {
+    auto g_ctx = make_shared<GlobalCtx>();
+    sptr<Worker> w_ctx = g_ctx->setup( 1, 0 );
+
+    auto file = make_shared<String>( CMAKE_PROJECT_ROOT "/Test/lexer.push" );
+    auto source = FileInput::read_file( *file );
+
+    auto cfg = TokenConfig::get_prelude_cfg();
+    cfg.operators.push_back( "=" );
+    cfg.operators.push_back( "+" );
+    cfg.operators.push_back( "." );
+    cfg.keywords.push_back( "let" );
+
+    FileInput buffer_input( file, w_ctx );
+    buffer_input.configure( cfg );
+    auto buffer = TokenBuffer::lex( buffer_input, source, *w_ctx );
+
+    FileInput fin( file, w_ctx );
+    fin.configure( cfg );
+    size_t idx = 0;
+    while ( true ) {
+        auto token = fin.get_token();
+        REQUIRE( idx < buffer->size() );
+        CHECK( buffer->to_token( idx ) == token );
+        CHECK( buffer->get( idx ).offset == token.offset );
+        idx++;
+        if ( token.type == Token::Type::eof )
+            break;
+    }
+    CHECK( idx == buffer->size() );
+
+    // Same identifiers share their content id
+    CHECK( buffer->get( 1 ).content == g_ctx->get_interner()->intern( "testing" ) );
+    CHECK( buffer->get( 1 ).file == g_ctx->get_file_id( file ) );
+    CHECK( buffer->get_line_table().line_count() == 10 );
+    CHECK( buffer->get_line_table().get_line( 4, *source ) == String( "main {" ) );
+}
+
+TEST_CASE( "Line table", "[lexer]" ) {
+    String unix_source = "first\n\nthird\nlast";
+    LineTable unix_table( unix_source );
+    CHECK( unix_table.line_count() == 4 );
+    CHECK( unix_table.line_of( 0 ) == 1 );
+    CHECK( unix_table.line_of( 5 ) == 1 );
+    CHECK( unix_table.line_of( 6 ) == 2 );
+    CHECK( unix_table.line_of( 7 ) == 3 );
+    CHECK( unix_table.get_lines( 2, 4, unix_source ) == std::list<String>{ "", "third", "last" } );
+
+    String mixed_source = "a\r\nb\rc\n";
+    LineTable mixed_table( mixed_source );
+    CHECK( mixed_table.line_count() == 4 );
+    CHECK( mixed_table.line_of( 3 ) == 2 );
+    CHECK( mixed_table.get_lines( 1, 3, mixed_source ) == std::list<String>{ "a", "b", "c" } );
+
+    auto g_ctx = make_shared<GlobalCtx>();
+    sptr<Worker> w_ctx = g_ctx->setup( 1, 0 );
+    auto file = make_shared<String>( CMAKE_PROJECT_ROOT "/Test/lexer.push" );
+    auto lines = w_ctx->do_query( get_source_lines, file, 4, 5 )->jobs.back()->to<std::list<String>>();
+    CHECK( lines == std::list<String>{ "main {", "\tletlet a= 4; " } );
+}
+
+TEST_CASE( "Pre-tokenized input", "[lexer]" ) {
+    auto g_ctx = make_shared<GlobalCtx>();
+    sptr<Worker> w_ctx = g_ctx->setup( 1, 0 );
+
+    auto file = make_shared<String>( CMAKE_PROJECT_ROOT "/Test/lexer.push" );
+    auto cfg = TokenConfig::get_prelude_cfg();
+    auto extended_cfg = cfg;
+    extended_cfg.operators.push_back( "=" );
+    extended_cfg.operators.push_back( "+" );
+    extended_cfg.keywords.push_back( "let" );
+
+    BufferedInput bin( file, w_ctx, FileInput::read_file( *file ) );
+    FileInput fin( file, w_ctx );
+    bin.configure( cfg );
+    fin.configure( cfg );
+
+    // Random access preview
+    CHECK( bin.preview_token_at( 3 ) == fin.preview_token_at( 3 ) );
+    CHECK( bin.preview_token() == fin.preview_token() );
+    CHECK( bin.preview_next_token() == fin.preview_next_token() );
+
+    // Backtracking
+    auto mark = bin.mark();
+    for ( size_t i = 0; i < 5; i++ )
+        bin.get_token();
+    bin.reset( mark );
+
+    // Reconfiguration in the middle of a file
+    while ( fin.preview_token().content != "main" )
+        CHECK( bin.get_token() == fin.get_token() );
+    bin.configure( extended_cfg );
+    fin.configure( extended_cfg );
+    while ( true ) {
+        auto token = fin.get_token();
+        CHECK( bin.get_token() == token );
+        if ( token.type == Token::Type::eof )
+            break;
+    }
+    CHECK( bin.get_token().type == Token::Type::eof );
+
+    auto lines = bin.get_lines( 4, 5, *w_ctx );
+    CHECK( lines == std::list<String>{ "main {", "\tletlet a= 4; " } );
+}
+
+TEST_CASE( "Prefetched source files", "[lexer]" ) {
+    auto g_ctx = make_shared<GlobalCtx>();
+    sptr<Worker> w_ctx = g_ctx->setup( 4, 0 );
+
+    std::vector<String> files = get_prelude_files();
+    CHECK( std::find( files.begin(), files.end(), *get_std_dir() + "/prelude/push.push" ) != files.end() );
+    files.push_back( CMAKE_PROJECT_ROOT "/Test/lexer.push" );
+    files.push_back( CMAKE_PROJECT_ROOT "/Test/not_existing.push" );
+
+    w_ctx->query( prefetch_source_files, files )->execute( *w_ctx )->wait();
+    for ( auto &file : files ) {
+        auto source_file = w_ctx->do_query( load_source_file, file )->jobs.back()->to<sptr<const SourceFile>>();
+        if ( file.find( "not_existing" ) != String::npos ) {
+            CHECK( source_file == nullptr );
+        } else {
+            REQUIRE( source_file != nullptr );
+            CHECK( *source_file->content == *FileInput::read_file( file ) );
+        }
+    }
+    g_ctx->wait_finished();
+}
+
+TEST_CASE( "Source store", "[lexer]" ) {
+    SourceStore store;
+    String file = CMAKE_PROJECT_ROOT "/Test/lexer.push";
+    auto source_file = store.load( file );
+    REQUIRE( source_file != nullptr );
+    CHECK( store.load( file ) == source_file );
+    CHECK( store.add( FileInput::read_file( file ) ) == source_file ); // deduplicated by content
+    CHECK( store.load( CMAKE_PROJECT_ROOT "/Test/not_existing.push" ) == nullptr );
+
+    // Modified files are read again
+    String tmp_file = ( fs::temp_directory_path() / "push_source_store.push" ).string();
+    std::ofstream( tmp_file ) << "a b c";
+    auto first = store.load( tmp_file );
+    std::ofstream( tmp_file ) << "a b c d";
+    auto second = store.load( tmp_file );
+    CHECK( second != first );
+    CHECK( *second->content == "a b c d" );
+    std::ofstream( tmp_file ) << "a b c";
+    CHECK( store.load( tmp_file ) == first ); // the old version is still in use
+    CHECK( store.buffer_count() == 3 );
+    fs::remove( tmp_file );
+}
+
+TEST_CASE( "Shared lexer tables", "[lexer]" ) {
+    auto g_ctx = make_shared<GlobalCtx>();
+    sptr<Worker> w_ctx = g_ctx->setup( 1, 0 );
+
+    auto cfg = TokenConfig::get_prelude_cfg();
+    auto extended_cfg = cfg;
+    extended_cfg.operators.push_back( "=" );
+
+    auto get_tables = [&]( const TokenConfig &cfg ) {
+        return w_ctx->do_query( compile_lexer_tables, cfg )->jobs.back()->to<sptr<const LexerTables>>();
+    };
+    auto tables = get_tables( cfg );
+    CHECK( tables == get_tables( TokenConfig::get_prelude_cfg() ) );
+    CHECK( tables->hash == LexerTables( cfg ).hash );
+
+    auto extended_tables = get_tables( extended_cfg );
+    CHECK( extended_tables != tables );
+    CHECK( extended_tables->hash != tables->hash );
+    CHECK( extended_tables->tokens_of( TokenLevel::normal ).at( "=" ) == Token::Type::op );
+    CHECK( tables->tokens_of( TokenLevel::normal ).count( "=" ) == 0 );
+    CHECK( tables->range( CharRangeType::ws ).count( '\n' ) == 1 );
+}
+
+TEST_CASE( "Incremental relexing", "[lexer]" ) {
+    auto g_ctx = make_shared<GlobalCtx>();
+    sptr<Worker> w_ctx = g_ctx->setup( 1, 0 );
+
+    auto file = make_shared<String>( CMAKE_PROJECT_ROOT "/Test/lexer.push" );
+    auto cfg = TokenConfig::get_prelude_cfg();
+    cfg.operators.push_back( "=" );
+    BufferedInput edited( file, w_ctx, FileInput::read_file( *file ) );
+    edited.configure( cfg );
+
+    // Compares the edited input with a completely lexed input
+    auto check_edit = [&]( size_t begin, size_t end, const String &replacement ) {
+        edited.apply_edit( begin, end, replacement );
+        BufferedInput fresh( file, w_ctx, edited.get_source() );
+        fresh.configure( cfg );
+        edited.reset( 0 );
+        while ( true ) {
+            auto token = fresh.get_token();
+            CHECK( edited.get_token() == token );
+            if ( token.type == Token::Type::eof )
+                break;
+        }
+    };
+
+    size_t main_pos = edited.get_source()->find( "main" );
+    check_edit( main_pos, main_pos, "x" ); // extend an identifier
+    check_edit( main_pos, main_pos + 1, "" ); // and revert it
+    check_edit( main_pos, main_pos, "a = b;\n" ); // insert new lines
+    check_edit( main_pos, main_pos, "/*" ); // open a comment which affects the rest of the file
+    check_edit( main_pos, main_pos + 2, "" );
+    check_edit( 0, 0, "\t" ); // edit at the beginning
+    check_edit( edited.get_source()->size(), edited.get_source()->size(), " end" ); // edit at the end
+    check_edit( main_pos / 2, main_pos * 2, "" ); // remove a larger range
+
+    // Files which are larger than the relexing window
+    auto large_source = make_shared<String>();
+    for ( size_t i = 0; i < 200; i++ )
+        *large_source += "fn_" + to_string( i ) + " { a = b; } // comment\n";
+    edited = BufferedInput( file, w_ctx, large_source );
+    edited.configure( cfg );
+    check_edit( 100, 100, "/*" );
+    check_edit( 100, 102, "" );
+    check_edit( 3000, 3010, "x = y" );
+}
+
+TEST_CASE( "Parallel chunked lexing", "[lexer]" ) {
+    auto g_ctx = make_shared<GlobalCtx>();
+    sptr<Worker> w_ctx = g_ctx->setup( 4, 0 );
+
+    auto file = make_shared<String>( "chunked" );
+    auto source = make_shared<String>();
+    for ( size_t i = 0; i < 50; i++ ) {
+        *source += "main" + to_string( i ) + " { let a = \"multi\nline\nstring\"; } // comment\n";
+        *source += "/* block\n comment /* nested\n */ */\t\n  \n";
+    }
+
+    auto cfg = TokenConfig::get_prelude_cfg();
+    cfg.operators.push_back( "=" );
+    cfg.keywords.push_back( "let" );
+
+    g_ctx->set_pref<SizeSV>( PrefType::lexer_chunk_size, 0 );
+    BufferedInput sequential( file, w_ctx, source );
+    sequential.configure( cfg );
+
+    g_ctx->set_pref<SizeSV>( PrefType::lexer_chunk_size, 64 );
+    BufferedInput parallel( file, w_ctx, source );
+    parallel.configure( cfg );
+
+    auto &seq_buffer = *sequential.get_buffer();
+    auto &par_buffer = *parallel.get_buffer();
+    REQUIRE( seq_buffer.size() == par_buffer.size() );
+    for ( size_t i = 0; i < seq_buffer.size(); i++ ) {
+        CHECK( par_buffer.to_token( i ) == seq_buffer.to_token( i ) );
+    }
+}
+
 #ifdef NDEBUG
 TEST_CASE( "Stress test lexing", "[lexer]" ) {
     auto g_ctx = make_shared<GlobalCtx>();
@@ -15,6 +15,7 @@
 #include "libpush/GlobalCtx.h"
 #include "libpush/Message.h"
 #include "libpush/UnitCtx.h"
+#include "libpush/util/StringInterner.h"
 
 #include "libpush/Worker.inl"
 #include "libpush/Job.inl"
@@ -114,3 +115,72 @@ TEST_CASE( "Query caching", "[basic_workflow]" ) {
     w_ctx->query( get_binary_from_source, std::list<String>{"a.b"} )->execute( *w_ctx )->wait();
     // this should print 1x "Using cached..." and 2x "Update cached..."
 }
+
+TEST_CASE( "Pass statistics", "[basic_workflow]" ) {
+    auto g_ctx = make_shared<GlobalCtx>();
+    auto w_ctx = g_ctx->setup( 1 );
+
+    // Disabled by default
+    {
+        PassTimer timer( *w_ctx, "stage" );
+        CHECK( !timer.enabled() );
+    }
+    CHECK( g_ctx->get_pass_stats().empty() );
+
+    g_ctx->set_pref<BoolSV>( PrefType::time_passes, true );
+    for ( size_t i = 0; i < 2; i++ ) {
+        PassTimer outer( *w_ctx, "outer" );
+        CHECK( outer.enabled() );
+        outer.add_nodes( 3 );
+        PassTimer inner( *w_ctx, "inner" );
+        Sleep( 2 );
+    }
+    auto stats = g_ctx->get_pass_stats();
+    REQUIRE( stats.size() == 2 );
+    CHECK( stats[0].name == "outer" );
+    CHECK( stats[0].runs == 2 );
+    CHECK( stats[0].nodes == 6 );
+    CHECK( stats[1].name == "inner" );
+    CHECK( stats[1].runs == 2 );
+    CHECK( stats[1].nodes == 0 );
+    CHECK( stats[1].wall_seconds >= 0.004 );
+    CHECK( stats[0].wall_seconds >= stats[1].wall_seconds ); // nested stages are included
+}
+
+TEST_CASE( "String interning", "[basic_workflow]" ) {
+    StringInterner interner;
+    CHECK( interner.intern( "" ) == StringInterner::EMPTY_ID );
+
+    // Intern overlapping strings concurrently
+    constexpr size_t thread_count = 8;
+    constexpr size_t string_count = 40000;
+    std::vector<std::vector<u32>> ids( thread_count );
+    std::vector<std::thread> threads;
+    for ( size_t t = 0; t < thread_count; t++ ) {
+        threads.emplace_back( [&, t]() {
+            for ( size_t i = 0; i < string_count; i++ ) {
+                ids[t].push_back( interner.intern( "str" + to_string( ( i * ( t + 1 ) ) % string_count ) ) );
+            }
+        } );
+    }
+    for ( auto &thread : threads )
+        thread.join();
+
+    CHECK( interner.size() == string_count + 1 );
+    for ( size_t t = 0; t < thread_count; t++ ) {
+        for ( size_t i = 0; i < string_count; i += 997 ) {
+            String expected = "str" + to_string( ( i * ( t + 1 ) ) % string_count );
+            CHECK( interner.get( ids[t][i] ) == expected );
+            CHECK( ids[t][i] == ids[0][( i * ( t + 1 ) ) % string_count] );
+        }
+    }
+
+    InternedString a( String( "some_name" ) );
+    InternedString b( "some_name" );
+    CHECK( a == b );
+    CHECK( a.get_id() == StringInterner::get_global()->intern( "some_name" ) );
+    CHECK( a.str() == "some_name" );
+    CHECK( a != InternedString( "other_name" ) );
+    CHECK( InternedString().empty() );
+    CHECK( ( a.str() + "_suffix" ) == "some_name_suffix" );
+}
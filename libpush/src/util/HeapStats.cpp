@@ -0,0 +1,43 @@
+// Copyright 2020 Erik Götzfried
+// Licensed under the Apache License, Version 2.0( the "License" );
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libpush/stdafx.h"
+#include "libpush/util/PassStats.h"
+#include <cstddef>
+#include <cstdlib>
+
+// Global allocation functions which count the heap usage (see PassStats.h). They are only linked into executables,
+// which add the libpush_heap_stats objects. Every allocation is prefixed with its size, so that it can be subtracted
+// again on deallocation
+constexpr size_t ALLOCATION_HEADER_SIZE = alignof( std::max_align_t );
+
+void *operator new( size_t size ) {
+    auto *block = static_cast<u8 *>( std::malloc( size + ALLOCATION_HEADER_SIZE ) );
+    if ( !block )
+        throw std::bad_alloc();
+    *reinterpret_cast<size_t *>( block ) = size;
+    count_allocation( size );
+    return block + ALLOCATION_HEADER_SIZE;
+}
+
+void operator delete( void *ptr ) noexcept {
+    if ( !ptr )
+        return;
+    auto *block = static_cast<u8 *>( ptr ) - ALLOCATION_HEADER_SIZE;
+    count_deallocation( *reinterpret_cast<size_t *>( block ) );
+    std::free( block );
+}
+
+void operator delete( void *ptr, size_t ) noexcept {
+    operator delete( ptr );
+}
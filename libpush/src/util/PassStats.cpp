@@ -0,0 +1,93 @@
+// Copyright 2020 Erik Götzfried
+// Licensed under the Apache License, Version 2.0( the "License" );
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libpush/stdafx.h"
+#include "libpush/util/PassStats.h"
+#include "libpush/GlobalCtx.h"
+
+// Heap counters of the process
+static std::atomic_bool heap_counted{ false };
+static std::atomic_size_t allocation_count{ 0 };
+static std::atomic_size_t allocated_bytes{ 0 };
+static std::atomic_size_t peak_allocated_bytes{ 0 }; // of the current (innermost) PassTimer run
+static std::atomic_size_t max_allocated_bytes{ 0 }; // of the whole process
+
+// Raises an atomic maximum to value
+static void update_max( std::atomic_size_t &max, size_t value ) {
+    size_t old = max.load();
+    while ( value > old && !max.compare_exchange_weak( old, value ) )
+        ;
+}
+
+void count_allocation( size_t size ) {
+    if ( !heap_counted.load( std::memory_order_relaxed ) )
+        heap_counted = true;
+    allocation_count++;
+    size_t current = allocated_bytes += size;
+    update_max( peak_allocated_bytes, current );
+    update_max( max_allocated_bytes, current );
+}
+
+void count_deallocation( size_t size ) {
+    allocated_bytes -= size;
+}
+
+bool heap_stats_available() {
+    return heap_counted.load();
+}
+
+HeapStats get_heap_stats() {
+    HeapStats stats;
+    stats.allocations = allocation_count.load();
+    stats.bytes = allocated_bytes.load();
+    stats.peak_bytes = max_allocated_bytes.load();
+    return stats;
+}
+
+size_t reset_heap_peak() {
+    size_t current = allocated_bytes.load();
+    peak_allocated_bytes = current;
+    return current;
+}
+
+size_t get_heap_peak() {
+    return peak_allocated_bytes.load();
+}
+
+PassTimer::PassTimer( Worker &w_ctx, const String &name ) {
+    if ( !w_ctx.global_ctx()->get_pref<BoolSV>( PrefType::time_passes ) )
+        return;
+    g_ctx = w_ctx.global_ctx().get();
+    run.name = name;
+    g_ctx->add_pass_stats( run ); // keeps the stages in the order of their first start
+    run.runs = 1;
+
+    start_allocations = allocation_count.load();
+    start_bytes = allocated_bytes.load();
+    outer_peak_bytes = peak_allocated_bytes.exchange( start_bytes );
+    start_cpu = std::clock();
+    start_time = std::chrono::steady_clock::now();
+}
+
+PassTimer::~PassTimer() {
+    if ( !g_ctx )
+        return;
+    run.wall_seconds = std::chrono::duration<f64>( std::chrono::steady_clock::now() - start_time ).count();
+    run.cpu_seconds = static_cast<f64>( std::clock() - start_cpu ) / CLOCKS_PER_SEC;
+    run.allocations = allocation_count.load() - start_allocations;
+    size_t peak = peak_allocated_bytes.load();
+    run.peak_bytes = peak > start_bytes ? peak - start_bytes : 0;
+    update_max( peak_allocated_bytes, outer_peak_bytes ); // the enclosing run has seen this peak too
+
+    g_ctx->add_pass_stats( run );
+}
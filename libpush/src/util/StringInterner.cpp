@@ -0,0 +1,69 @@
+// Copyright 2020 Erik Götzfried
+// Licensed under the Apache License, Version 2.0( the "License" );
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "libpush/stdafx.h"
+#include "libpush/util/StringInterner.h"
+
+StringInterner::StringInterner() {
+    next_id = 0;
+    for ( auto &chunk : chunks )
+        chunk.store( nullptr, std::memory_order_relaxed );
+    intern( "" );
+}
+
+StringInterner::~StringInterner() {
+    for ( auto &chunk : chunks )
+        delete[] chunk.load();
+}
+
+u32 StringInterner::intern( const String &str ) {
+    auto &shard = shards[std::hash<String>{}( str ) % SHARD_COUNT];
+    Lock lock( shard.mtx );
+    auto itr = shard.ids.find( str );
+    if ( itr != shard.ids.end() )
+        return itr->second;
+
+    // Publish the new string before its id can be used
+    u32 id;
+    {
+        Lock alloc_lock( alloc_mtx );
+        id = next_id.load( std::memory_order_relaxed );
+        if ( ( id >> CHUNK_BITS ) >= MAX_CHUNKS ) {
+            LOG_ERR( "String interner is full" );
+            return EMPTY_ID;
+        }
+        String *chunk = chunks[id >> CHUNK_BITS].load( std::memory_order_relaxed );
+        if ( !chunk ) {
+            chunk = new String[CHUNK_SIZE];
+            chunks[id >> CHUNK_BITS].store( chunk, std::memory_order_release );
+        }
+        chunk[id & ( CHUNK_SIZE - 1 )] = str;
+        next_id.store( id + 1, std::memory_order_release );
+    }
+    shard.ids[str] = id;
+    return id;
+}
+
+const String &StringInterner::get( u32 id ) const {
+    if ( id >= next_id.load( std::memory_order_acquire ) ) {
+        LOG_ERR( "Requested unknown interned string id " + to_string( id ) );
+        id = EMPTY_ID;
+    }
+    return chunks[id >> CHUNK_BITS].load( std::memory_order_acquire )[id & ( CHUNK_SIZE - 1 )];
+}
+
+sptr<StringInterner> StringInterner::get_global() {
+    static sptr<StringInterner> global = make_shared<StringInterner>();
+    return global;
+}
@@ -0,0 +1,36 @@
+// Copyright 2020 Erik Götzfried
+// Licensed under the Apache License, Version 2.0( the "License" );
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "libpushc/stdafx.h"
+#include "libpushc/Expression.h"
+
+// Version of the binary AST format. Must be increased whenever the layout of AstNode changes
+constexpr u32 AST_CACHE_FORMAT_VERSION = 3;
+
+// NOT A QUERY. Serializes an AST into a compact binary blob. All positions must refer to @param file. Returns false if
+// the AST can't be serialized
+bool serialize_ast( const AstNode &ast, const String &file, std::vector<u8> &blob );
+
+// NOT A QUERY. Restores an AST which was created with serialize_ast(). Positions will refer to @param file. Returns
+// false if the blob is malformed
+bool deserialize_ast( const std::vector<u8> &blob, sptr<String> file, AstNode &ast );
+
+// NOT A QUERY. Creates the cache key of a source which is parsed with a prelude (includes the compiler version)
+u64 get_ast_cache_key( const String &source, const PreludeConfig &conf );
+
+// NOT A QUERY. Loads an AST from the cache directory. Returns false if there is no valid entry for the key
+bool load_cached_ast( const String &cache_dir, u64 key, sptr<String> file, AstNode &ast );
+
+// NOT A QUERY. Stores an AST in the cache directory. Returns false if the AST could not be stored
+bool store_cached_ast( const String &cache_dir, u64 key, const AstNode &ast, const String &file );
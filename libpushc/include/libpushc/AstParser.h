@@ -14,6 +14,7 @@
 #pragma once
 #include "libpushc/stdafx.h"
 #include "libpushc/CrateCtx.h"
+#include "libpush/input/BufferedInput.h"
 
 // Create the Abstract Syntax tree of the current compilation unit
 void get_ast( JobsBuilder &jb, UnitCtx &parent_ctx );
@@ -21,12 +22,29 @@ void get_ast( JobsBuilder &jb, UnitCtx &parent_ctx );
 // Parse the AST from an input file (of this compilation unit)
 void parse_ast( JobsBuilder &jb, UnitCtx &parent_ctx );
 
-// NOT A QUERY. Translates the prelude syntax rules into ast syntax rules
+// Translates syntaxes into ast syntax rules. Equal syntaxes share the same table
+void compile_syntax_table( const std::map<SyntaxType, std::vector<Operator>> &syntaxes, JobsBuilder &jb,
+                           UnitCtx &parent_ctx );
+
+// NOT A QUERY. Loads the syntax rules of the current prelude
 void load_syntax_rules( Worker &w_ctx, CrateCtx &c_ctx );
 
 // NOT A QUERY. Parses a scope
 AstNode parse_scope( sptr<SourceInput> &input, Worker &w_ctx, CrateCtx &c_ctx, Token::Type end_token,
                         Token *last_token );
 
+// NOT A QUERY. Finds the boundaries of the top-level items in the tokens [begin..eof) of a buffer. Items end with a
+// statement divider or a block on the top level, if the next item begins with an identifier. Returns the first token
+// of each item followed by the eof token index
+std::vector<size_t> find_top_level_items( const TokenBuffer &tokens, size_t begin );
+
+// Parses each item [boundaries[i]..boundaries[i+1]) of an input as a separate job. Each job returns the parsed
+// expressions and the messages of the item
+void parse_top_level_items( sptr<BufferedInput> input, sptr<CrateCtx> c_ctx, const std::vector<size_t> &boundaries,
+                            JobsBuilder &jb, UnitCtx &parent_ctx );
+
+// NOT A QUERY. Parses the global scope of a file. Top-level items are parsed in parallel if possible
+AstNode parse_global_scope( sptr<SourceInput> &input, Worker &w_ctx, sptr<CrateCtx> c_ctx );
+
 // NOT A QUERY. Loads basic types like int, string, etc
 void load_base_types( CrateCtx &c_ctx, Worker &w_ctx, PreludeConfig &cfg );
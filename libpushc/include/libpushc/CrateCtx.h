@@ -14,6 +14,7 @@
 #pragma once
 #include "libpushc/stdafx.h"
 #include "libpushc/Intrinsics.h"
+#include "libpush/util/StringInterner.h"
 
 // Identifies a type
 using TypeId = u32;
@@ -56,12 +57,45 @@ struct SyntaxRule {
     std::vector<AstNode> expr_list; // list which has to be matched against
 
     // Checks if a reversed expression list matches this syntax rule
-    bool matches_reversed( std::vector<AstNode> &rev_list );
+    bool matches_reversed( const std::vector<AstNode *> &rev_list ) const;
 
-    // Create a new expression according to this rule.
+    // Create a new expression according to this rule. Matched expressions may be moved out of the list.
     std::function<AstNode( std::vector<AstNode> &, Worker &w_ctx )> create;
 };
 
+enum class ExprType;
+
+// Maps the last pattern element of each syntax rule to the rule, so that only rules which can match the newest
+// expression have to be checked. Rule indices are stored in the order of the rules (by precedence).
+struct SyntaxRuleIndex {
+    std::unordered_map<InternedString, std::vector<size_t>> by_token; // token patterns by their content
+    std::map<ExprType, std::vector<size_t>> by_type; // typed patterns without token content
+    std::vector<size_t> by_props; // property-only patterns
+    std::vector<size_t> always; // rules without a pattern
+    size_t rule_count = 0;
+
+    // Creates the index from the sorted list of rules
+    void build( const std::vector<SyntaxRule> &rules );
+
+    // Collects the sorted indices of all rules which could match a path whose newest (not static) expression is
+    // newest_expr (nullptr if there is none). allow_split should be true if that expression may be split up during
+    // backtracing.
+    void collect_candidates( const std::vector<SyntaxRule> &rules, const AstNode *newest_expr, bool allow_split,
+                             std::vector<size_t> &candidates ) const;
+
+private:
+    // Adds the rules which could match a single expression
+    void add_candidates_of( const std::vector<SyntaxRule> &rules, const AstNode &expr,
+                            std::vector<size_t> &candidates ) const;
+};
+
+// Syntax rules compiled from the syntaxes of a prelude. Immutable, so that all crates with the same syntaxes can share
+// them
+struct SyntaxTable {
+    std::vector<SyntaxRule> rules; // sorted by bias and precedence
+    SyntaxRuleIndex index; // dispatch index of rules
+};
+
 // Maps syntax item labels to their position in a syntax
 using LabelMap = std::map<String, size_t>;
 
@@ -99,12 +133,12 @@ public:
 
 // Identifies a local symbol (must be chained to get a full symbol identification)
 struct SymbolIdentifier {
-    String name; // the local symbol name (empty means anonymous scope)
+    InternedString name; // the local symbol name (empty means anonymous scope)
 
     // Signature of a parameter or return type
     struct ParamSig {
         TypeId type = 0; // type of the parameter
-        String name; // name of the parameter (not for return types)
+        InternedString name; // name of the parameter (not for return types)
         bool ref = false; // whether the value is borrowed
         bool mut = false; // whether the value is mutable
 
@@ -137,6 +171,9 @@ struct SymbolGraphNode {
     TypeId value = 0; // type/value of this symbol (every function has its own type; for structs this is struct body;
                       // for (local) variables this is 0)
     TypeId type = 0; // the type behind the value of this symbol
+
+    std::unordered_map<InternedString, std::vector<SymbolId>>
+        sub_nodes_by_name; // sub_nodes indexed by their name (in the order of sub_nodes)
 };
 
 // An entry in the type table, representing a type
@@ -198,7 +235,7 @@ struct MirVariable {
         count
     } type = Type::value;
 
-    String name; // the original variable name (temporaries have an empty name)
+    InternedString name; // the original variable name (temporaries have an empty name)
     TypeId value_type = 0; // type of the value of this variable
     bool mut = false; // whether this variable can be updated
     MirVarId ref = 0; // referred variable (for l_ref or for method access; should never reference a l_ref)
@@ -249,17 +286,25 @@ struct CrateCtx {
     MirLiteral true_val = { true, 0xff, 1 }; // the representation of the boolean "true" value
     MirLiteral false_val = { true, 0, 1 }; // the representation of the boolean "false" value
 
-    std::vector<SyntaxRule> rules;
+    sptr<const SyntaxTable> syntax_table; // shared syntax rules of the prelude
     std::unordered_map<String, std::pair<TypeId, u64>> literals_map; // maps literals to their typeid and mem_value
+    std::unordered_map<SymbolId, std::unordered_map<size_t, std::vector<SymbolId>>>
+        template_instances; // instances of each template by the hash of their template values
 
+    std::mutex symbol_graph_mtx; // guards the symbol graph and type table while passes run in parallel
 
+    CrateCtx();
+};
+
+// Contains the state of a single traversal over the AST. Every traversal has its own context, so that independent
+// subtrees can be traversed concurrently
+struct TraversalCtx {
     SymbolId current_scope = ROOT_SYMBOL; // new symbols are created on top of this one
     std::vector<std::vector<SymbolSubstitution>> current_substitutions; // Substitution rules for each new scope
 
     std::vector<std::vector<MirVarId>> curr_living_vars;
-    std::vector<std::map<String, std::vector<MirVarId>>> curr_name_mapping; // mappes names to stacks of shaddowned vars
+    std::vector<std::unordered_map<InternedString, std::vector<MirVarId>>>
+        curr_name_mapping; // mappes names to stacks of shaddowned vars
     MirVarId curr_self_var = 0; // describes the current self parameter var
     TypeId curr_self_type = 0; // describes which type is the current object type
-
-    CrateCtx();
 };
@@ -129,6 +129,40 @@ enum class ExprProperty {
     count
 };
 
+// Set of expression properties, stored as bit flags
+class ExprPropertySet {
+    u32 bits = 0;
+
+    static constexpr u32 bit( ExprProperty prop ) { return 1u << static_cast<u32>( prop ); }
+
+public:
+    ExprPropertySet() {}
+    ExprPropertySet( std::initializer_list<ExprProperty> list ) {
+        for ( auto prop : list )
+            insert( prop );
+    }
+
+    void insert( ExprProperty prop ) { bits |= bit( prop ); }
+    void erase( ExprProperty prop ) { bits &= ~bit( prop ); }
+    void clear() { bits = 0; }
+    bool empty() const { return bits == 0; }
+    bool contains( ExprProperty prop ) const { return ( bits & bit( prop ) ) != 0; }
+    // Returns whether all properties of other are also in this set
+    bool contains_all( const ExprPropertySet &other ) const { return ( bits & other.bits ) == other.bits; }
+
+    bool operator==( const ExprPropertySet &other ) const { return bits == other.bits; }
+    bool operator!=( const ExprPropertySet &other ) const { return bits != other.bits; }
+
+    // Raw access to the bit flags (e. g. for serialization)
+    u32 get_bits() const { return bits; }
+    static ExprPropertySet from_bits( u32 bits ) {
+        ExprPropertySet set;
+        set.bits = bits;
+        return set;
+    }
+};
+static_assert( static_cast<u32>( ExprProperty::count ) <= 32, "ExprPropertySet has too few bits" );
+
 // Defines indices to access named entries in ast nodes
 enum class AstChild {
     symbol,
@@ -151,79 +185,241 @@ enum class AstChild {
     count
 };
 
-// The nodes of which the AST is build up
-struct AstNode {
-    ExprType type = ExprType::none;
-    std::set<ExprProperty> props;
+// Refers to an expression of the original list of a separable expression, without storing it twice
+struct OriginalListEntry {
+    enum class Source {
+        child, // index into AstNode::children
+        named, // AstChild key of AstNode::named
+        stored, // index into AstNodePayload::original_stored
+    } source;
+    u32 index;
+};
 
-    PosInfo pos_info;
+struct AstNode;
+
+// Rarely used data of an AstNode. Stored outside of the node to keep nodes small
+struct AstNodePayload {
     std::vector<AstNode> static_statements;
     std::vector<AstNode> annotations;
     std::vector<SymbolSubstitution> substitutions; // in decl scopes
 
-    std::vector<AstNode> original_list; // if separable
+    std::vector<OriginalListEntry> original_list; // if separable; the matched expressions of the syntax rule
+    std::vector<AstNode> original_stored; // matched expressions which are not children (e. g. operator tokens)
+    String literal_string; // only for string literals
+};
+
+// Owns the payload of an AstNode. The payload is allocated on first write and copied with its node
+class AstPayloadPtr {
+    std::unique_ptr<AstNodePayload> ptr;
+
+public:
+    AstPayloadPtr() {}
+    AstPayloadPtr( const AstPayloadPtr &other );
+    AstPayloadPtr( AstPayloadPtr &&other ) noexcept = default;
+    ~AstPayloadPtr();
+    AstPayloadPtr &operator=( const AstPayloadPtr &other );
+    AstPayloadPtr &operator=( AstPayloadPtr &&other ) noexcept;
+
+    // Returns the payload or nullptr if none was written
+    AstNodePayload *get() const { return ptr.get(); }
+    // Returns the payload and allocates it if required
+    AstNodePayload &get_or_create();
+};
+
+// Named children of an AstNode (see AstChild). A fixed index array maps every AstChild to a slot in a small node pool,
+// so no lookup has to search. Iterates in the order of AstChild like a std::map. References to children stay valid
+// when other children are added
+class AstChildMap {
+public:
+    using value_type = std::pair<const AstChild, AstNode>;
+
+private:
+    static constexpr u8 NO_SLOT = 0xFF;
+    static constexpr size_t KEY_COUNT = static_cast<size_t>( AstChild::count );
+
+    std::array<u8, KEY_COUNT> slots; // index into pool or NO_SLOT
+    std::vector<std::unique_ptr<value_type>> pool; // children in insertion order
+
+    // Iterates over the existing children in key order
+    template <typename MapT, typename ValueT>
+    class Iterator {
+        MapT *map;
+        size_t key; // KEY_COUNT marks the end
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = ValueT;
+        using difference_type = std::ptrdiff_t;
+        using pointer = ValueT *;
+        using reference = ValueT &;
+
+        Iterator( MapT *map, size_t key ) : map( map ), key( key ) {}
+        operator Iterator<const AstChildMap, const ValueT>() const { return { map, key }; }
+
+        ValueT &operator*() const { return *map->pool[map->slots[key]]; }
+        ValueT *operator->() const { return map->pool[map->slots[key]].get(); }
+
+        Iterator &operator++() {
+            key = map->next_key( key + 1 );
+            return *this;
+        }
+        Iterator operator++( int ) {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+        Iterator &operator--() {
+            do {
+                key--;
+            } while ( map->slots[key] == NO_SLOT );
+            return *this;
+        }
+        Iterator operator--( int ) {
+            Iterator old = *this;
+            --*this;
+            return old;
+        }
+
+        bool operator==( const Iterator &other ) const { return key == other.key; }
+        bool operator!=( const Iterator &other ) const { return key != other.key; }
+    };
+
+    // Returns the first existing key starting at @param key or KEY_COUNT
+    size_t next_key( size_t key ) const {
+        while ( key < KEY_COUNT && slots[key] == NO_SLOT )
+            key++;
+        return key;
+    }
+
+public:
+    using iterator = Iterator<AstChildMap, value_type>;
+    using const_iterator = Iterator<const AstChildMap, const value_type>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    AstChildMap() { slots.fill( NO_SLOT ); }
+    AstChildMap( const AstChildMap &other );
+    AstChildMap( AstChildMap &&other ) noexcept;
+    ~AstChildMap();
+    AstChildMap &operator=( const AstChildMap &other );
+    AstChildMap &operator=( AstChildMap &&other ) noexcept;
+
+    // Returns the child of a key. Creates it if it does not exist yet
+    AstNode &operator[]( AstChild key );
+
+    // Returns the child of a key. Throws std::out_of_range if it does not exist
+    AstNode &at( AstChild key );
+    const AstNode &at( AstChild key ) const { return const_cast<AstChildMap *>( this )->at( key ); }
+
+    iterator find( AstChild key ) {
+        return slots[static_cast<size_t>( key )] == NO_SLOT ? end() : iterator( this, static_cast<size_t>( key ) );
+    }
+    const_iterator find( AstChild key ) const { return const_cast<AstChildMap *>( this )->find( key ); }
+
+    // Copies the children of other keys. Existing children are kept
+    template <typename InputIt>
+    void insert( InputIt first, InputIt last ) {
+        for ( ; first != last; first++ ) {
+            if ( slots[static_cast<size_t>( first->first )] == NO_SLOT )
+                operator[]( first->first ) = first->second;
+        }
+    }
+
+    void clear() {
+        slots.fill( NO_SLOT );
+        pool.clear();
+    }
+
+    size_t size() const { return pool.size(); }
+    bool empty() const { return pool.empty(); }
+
+    iterator begin() { return iterator( this, next_key( 0 ) ); }
+    iterator end() { return iterator( this, KEY_COUNT ); }
+    const_iterator begin() const { return const_iterator( this, next_key( 0 ) ); }
+    const_iterator end() const { return const_iterator( this, KEY_COUNT ); }
+    reverse_iterator rbegin() { return reverse_iterator( end() ); }
+    reverse_iterator rend() { return reverse_iterator( begin() ); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator( end() ); }
+    const_reverse_iterator rend() const { return const_reverse_iterator( begin() ); }
+};
+
+// The nodes of which the AST is build up
+struct AstNode {
+    ExprType type = ExprType::none;
+    ExprPropertySet props;
+
+    PosInfo pos_info;
     u32 precedence = 0; // for AST construction
-    std::map<AstChild, AstNode> named; // see AstChild
+    AstChildMap named; // see AstChild
     std::vector<AstNode> children; // unnamed children (list)
 
-    Token token; // only for token and operator
-    String symbol_name; // only for atomic symbol and operator (called function)
+    InternedString token; // content of the token; only for token and operator
+    Token::Type token_type = Token::Type::count; // only for token and operator
+    InternedString symbol_name; // only for atomic symbol and operator (called function)
     SymbolId symbol = 0; // only for atomic symbol
     SymbolId scope_symbol = 0; // only for scope exprs
     TypeId literal_type = 0; // only for literals whose type is known
     Number literal_number = 0; // only for numeric/boolean literals
-    String literal_string; // only for string literals
     bool continue_eval = true; // only for loops (for what value the loop is continued)
-    Operator::RangeOperatorType range_type; // only for ranges
+    Operator::RangeOperatorType range_type = Operator::RangeOperatorType::count; // only for ranges
+    AstPayloadPtr payload; // see get_payload(). Last member, because it may own the source of a move assignment
 
     // General management
 
     // Returns whether the expr has the specified property
-    bool has_prop( ExprProperty prop ) { return props.find( prop ) != props.end(); }
+    bool has_prop( ExprProperty prop ) const { return props.contains( prop ); }
+
+    // Returns the rarely used data of this expr or nullptr if none was written
+    AstNodePayload *get_payload() { return payload.get(); }
+    const AstNodePayload *get_payload() const { return payload.get(); }
+    // Returns the rarely used data of this expr to change it
+    AstNodePayload &mutable_payload() { return payload.get_or_create(); }
 
     // AST generation
 
     // Checks if matches the expression
-    bool matches( const AstNode &pattern ) {
+    bool matches( const AstNode &pattern ) const {
         if ( pattern.type != ExprType::none && pattern.type != type )
             return false;
-        if ( pattern.type == ExprType::token && pattern.token.content != token.content )
+        if ( pattern.type == ExprType::token && pattern.token != token )
             return false;
-        for ( auto &prop : pattern.props ) {
-            if ( props.find( prop ) == props.end() )
-                return false;
-        }
-        return true;
+        return props.contains_all( pattern.props );
     }
 
     // Generates the properties to the expr type
     void generate_new_props();
 
+    // Returns an expression of the original list. Only valid while the AST is constructed
+    AstNode &original_at( size_t idx );
+    const AstNode &original_at( size_t idx ) const { return const_cast<AstNode *>( this )->original_at( idx ); }
+
     // Separates the expression and all its sub expressions depending on their precedence.
-    // Also adds all static statements recursively
-    void split_prepend_recursively( std::vector<AstNode> &rev_list, std::vector<AstNode> &stst_set, u32 prec, bool ltr,
-                                    u8 rule_length );
+    // Also adds all static statements recursively. Only references to the sub expressions are collected, so they must
+    // be moved out before this expression is changed
+    void split_prepend_recursively( std::vector<AstNode *> &rev_list, std::vector<AstNode *> &stst_set, u32 prec,
+                                    bool ltr, u8 rule_length );
 
     // Symbol methods
 
-    // This method is used to minimize the needed code to implement a visitor pattern using templates (see
-    // post_visit_impl()). Returns false if the pass failed
+    // Runs a single visitor pass on this expr and all its sub-expressions (see VisitorPasses.h to run multiple passes).
+    // Returns false if the pass failed
     bool visit( CrateCtx &c_ctx, Worker &w_ctx, VisitorPassType vpt, AstNode &parent, bool expect_operand );
 
     // Creates a symbol chain from this expression which contains symbols or scoped symbols
-    sptr<std::vector<SymbolIdentifier>> get_symbol_chain( CrateCtx &c_ctx, Worker &w_ctx );
+    sptr<std::vector<SymbolIdentifier>> get_symbol_chain( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx );
 
     // Checks very basic semantic conditions on an expr. Returns false when an error has been found
     bool basic_semantic_check( CrateCtx &c_ctx, Worker &w_ctx );
 
     // Does basic transformations, which don't require symbol information
-    bool first_transformation( CrateCtx &c_ctx, Worker &w_ctx, AstNode &parent, bool &expect_operand );
+    bool first_transformation( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, AstNode &parent,
+                               bool &expect_operand );
 
     // Prepares the symbol discovery for this expr
-    bool symbol_discovery( CrateCtx &c_ctx, Worker &w_ctx );
+    bool symbol_discovery( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx );
 
     // Used in the symbol discovery pass
-    bool post_symbol_discovery( CrateCtx &c_ctx, Worker &w_ctx );
+    bool post_symbol_discovery( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx );
 
     // Updates the internal symbol id reference
     void update_symbol_id( SymbolId new_id );
@@ -238,21 +434,79 @@ struct AstNode {
     // Mir methods
 
     // Called on structs and alike to resolve the type symbols (which requires all symbols to be discovered)
-    void find_types( CrateCtx &c_ctx, Worker &w_ctx );
+    void find_types( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx );
 
     // Parses the expr and appends the generated instructions to the function. Returns the result variable
-    MirVarId parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func );
+    MirVarId parse_mir( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, FunctionImplId func );
 
     // Create variable bindings from this expr. Returns the var, which was bound to
-    MirVarId bind_vars( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func, MirVarId in_var,
+    MirVarId bind_vars( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, FunctionImplId func, MirVarId in_var,
                                              AstNode &bind_expr, bool checked_deconstruction );
 
     // Check if a deconstruction is possible/valid. Returns the var with the check result
-    MirVarId check_deconstruction( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func,
+    MirVarId check_deconstruction( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, FunctionImplId func,
                                                         MirVarId in_var, AstNode &bind_expr );
 
     // Debugging & message methods
 
     // Returns a string representation of this ast node for debugging purposes
     String get_debug_repr() const;
+    // Returns the representation of this node from the representations of its sub-expressions
+    String compose_debug_repr( const std::unordered_map<const AstNode *, String> &sub_reprs ) const;
 };
+
+inline AstChildMap::AstChildMap( const AstChildMap &other ) : slots( other.slots ) {
+    pool.reserve( other.pool.size() );
+    for ( auto &entry : other.pool )
+        pool.push_back( std::make_unique<value_type>( *entry ) );
+}
+inline AstChildMap::AstChildMap( AstChildMap &&other ) noexcept
+        : slots( other.slots ), pool( std::move( other.pool ) ) {
+    other.clear();
+}
+inline AstChildMap::~AstChildMap() {}
+inline AstChildMap &AstChildMap::operator=( const AstChildMap &other ) {
+    if ( this != &other )
+        *this = AstChildMap( other );
+    return *this;
+}
+inline AstChildMap &AstChildMap::operator=( AstChildMap &&other ) noexcept {
+    AstChildMap tmp( std::move( other ) ); // other may be owned by this map
+    slots = tmp.slots;
+    pool.swap( tmp.pool );
+    return *this;
+}
+
+inline AstNode &AstChildMap::operator[]( AstChild key ) {
+    u8 &slot = slots[static_cast<size_t>( key )];
+    if ( slot == NO_SLOT ) {
+        slot = static_cast<u8>( pool.size() );
+        pool.push_back( std::make_unique<value_type>( key, AstNode() ) );
+    }
+    return pool[slot]->second;
+}
+inline AstNode &AstChildMap::at( AstChild key ) {
+    u8 slot = slots[static_cast<size_t>( key )];
+    if ( slot == NO_SLOT )
+        throw std::out_of_range( "AstChildMap::at" );
+    return pool[slot]->second;
+}
+
+inline AstPayloadPtr::AstPayloadPtr( const AstPayloadPtr &other )
+        : ptr( other.ptr ? std::make_unique<AstNodePayload>( *other.ptr ) : nullptr ) {}
+inline AstPayloadPtr::~AstPayloadPtr() {}
+inline AstPayloadPtr &AstPayloadPtr::operator=( const AstPayloadPtr &other ) {
+    if ( this != &other )
+        *this = AstPayloadPtr( other );
+    return *this;
+}
+inline AstPayloadPtr &AstPayloadPtr::operator=( AstPayloadPtr &&other ) noexcept {
+    AstPayloadPtr tmp( std::move( other ) ); // other may be owned by this payload
+    ptr.swap( tmp.ptr );
+    return *this;
+}
+inline AstNodePayload &AstPayloadPtr::get_or_create() {
+    if ( !ptr )
+        ptr = std::make_unique<AstNodePayload>();
+    return *ptr;
+}
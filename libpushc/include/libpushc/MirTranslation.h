@@ -21,24 +21,26 @@ void get_mir( JobsBuilder &jb, UnitCtx &parent_ctx );
 // FOLLOWING FUNCTIONS ARE NOT QUERIES
 
 // Creates a new mir operation and does some checks. @param result = 0 will create a new variable
-MirEntryId create_operation( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId function, AstNode &original_expr,
-                             MirEntry::Type type, MirVarId result, std::vector<MirVarId> parameters );
+MirEntryId create_operation( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, FunctionImplId function,
+                             AstNode &original_expr, MirEntry::Type type, MirVarId result,
+                             std::vector<MirVarId> parameters );
 
 // Creates a MIR function call from a symbol id. Handles dangling varameters etc. See crate_operation.
-MirEntryId create_call( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId calling_function, AstNode &original_expr,
-                        SymbolId called_function, MirVarId result, std::vector<MirVarId> parameters );
+MirEntryId create_call( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, FunctionImplId calling_function,
+                        AstNode &original_expr, SymbolId called_function, MirVarId result,
+                        std::vector<MirVarId> parameters );
 
 // Creates a new local variable and returns its id
-MirVarId create_variable( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId function, AstNode *original_expr,
-                          const String &name = "" );
+MirVarId create_variable( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, FunctionImplId function,
+                          AstNode *original_expr, const String &name = "" );
 
 // Destroys a local variable in a function
-void drop_variable( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId function, AstNode &original_expr,
-                    MirVarId variable );
+void drop_variable( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, FunctionImplId function,
+                    AstNode &original_expr, MirVarId variable );
 
 // Call this e. g. when a variable is moved
-void remove_from_local_living_vars( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId function, AstNode &original_expr,
-                                    MirVarId variable );
+void remove_from_local_living_vars( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, FunctionImplId function,
+                                    AstNode &original_expr, MirVarId variable );
 
 // Analyses the function signature and updates the type if necessary
-void analyse_function_signature( CrateCtx &c_ctx, Worker &w_ctx, SymbolId function );
+void analyse_function_signature( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, SymbolId function );
@@ -19,3 +19,12 @@ void load_prelude( sptr<String> prelude, JobsBuilder &jb, UnitCtx &parent_ctx );
 
 // Loads a prelude file
 void load_prelude_file( sptr<String> path, JobsBuilder &jb, UnitCtx &ctx );
+
+// Serializes an operator. Used to identify equal syntax definitions
+std::ostream &operator<<( std::ostream &stream, const Operator &op );
+
+// Serializes all syntaxes of a prelude. Used to identify equal syntax definitions
+std::ostream &operator<<( std::ostream &stream, const std::map<SyntaxType, std::vector<Operator>> &syntaxes );
+
+// Serializes a whole prelude configuration. Used to identify equal preludes
+std::ostream &operator<<( std::ostream &stream, const PreludeConfig &conf );
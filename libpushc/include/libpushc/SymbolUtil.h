@@ -35,7 +35,7 @@ std::vector<SymbolId> find_relative_symbol_by_identifier_chain( CrateCtx &c_ctx,
                                                                 SymbolId parent );
 
 // Searches for a local (and global) sub-symbol by name chain and returns its id
-std::vector<SymbolId> find_local_symbol_by_identifier_chain( CrateCtx &c_ctx, Worker &w_ctx,
+std::vector<SymbolId> find_local_symbol_by_identifier_chain( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx,
                                                              sptr<std::vector<SymbolIdentifier>> identifier_chain );
 
 // Returns a list of indices of members which match the identifier
@@ -55,7 +55,7 @@ String get_full_symbol_name( CrateCtx &c_ctx, Worker &w_ctx, SymbolId symbol );
 sptr<std::vector<SymbolIdentifier>> get_symbol_chain_from_symbol( CrateCtx &c_ctx, Worker &w_ctx, SymbolId symbol );
 
 // Applies local alias rules to a name chain. Returns false on error
-bool alias_name_chain( CrateCtx &c_ctx, Worker &w_ctx, std::vector<SymbolIdentifier> &symbol_chain,
+bool alias_name_chain( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, std::vector<SymbolIdentifier> &symbol_chain,
                        const AstNode &symbol );
 
 // Creates a new symbol from a global name. @param name may not contain scope operators
@@ -66,7 +66,8 @@ SymbolId create_new_relative_symbol( CrateCtx &c_ctx, Worker &w_ctx, const Symbo
                                      SymbolId parent_symbol );
 
 // Creates a new symbol from a local name. @param name may not contain scope operators
-SymbolId create_new_local_symbol( CrateCtx &c_ctx, Worker &w_ctx, const SymbolIdentifier &identifier );
+SymbolId create_new_local_symbol( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx,
+                                  const SymbolIdentifier &identifier );
 
 // Creates a new global symbol from a symbol chain. Existing symbols are skipped
 SymbolId create_new_global_symbol_from_name_chain( CrateCtx &c_ctx, Worker &w_ctx,
@@ -78,7 +79,7 @@ SymbolId create_new_relative_symbol_from_name_chain( CrateCtx &c_ctx, Worker &w_
                                                      SymbolId parent_symbol );
 
 // Creates a new local symbol from a symbol chain. Existing symbols are skipped
-SymbolId create_new_local_symbol_from_name_chain( CrateCtx &c_ctx, Worker &w_ctx,
+SymbolId create_new_local_symbol_from_name_chain( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx,
                                                   const sptr<std::vector<SymbolIdentifier>> symbol_chain,
                                                   const AstNode &symbol );
 
@@ -92,15 +93,19 @@ TypeId create_new_internal_type( CrateCtx &c_ctx, Worker &w_ctx );
 // Creates a new type from a existing symbol
 TypeId create_new_type( CrateCtx &c_ctx, Worker &w_ctx, SymbolId from_symbol );
 
-// Instantiates a template, by creating a new type and symbol if necessary
+// Creates a hash of template values, which is equal for equal values
+size_t hash_template_values( const std::vector<std::pair<TypeId, ConstValue>> &template_values );
+
+// Instantiates a template, by creating a new type and symbol if necessary. Instances are cached by their template
+// values
 SymbolId instantiate_template( CrateCtx &c_ctx, Worker &w_ctx, SymbolId from_template,
                                std::vector<std::pair<TypeId, ConstValue>> &template_values );
 
 // Changes the current scope symbol to be @param new_scope
-void switch_scope_to_symbol( CrateCtx &c_ctx, Worker &w_ctx, SymbolId new_scope );
+void switch_scope_to_symbol( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, SymbolId new_scope );
 
 // Sets the current scope symbol to its parent scope
-void pop_scope( CrateCtx &c_ctx, Worker &w_ctx );
+void pop_scope( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx );
 
 // Checks if the symbol container contains exactly one element and prints an error otherwise (and returns false)
 bool expect_exactly_one_symbol( CrateCtx &c_ctx, Worker &w_ctx, std::vector<SymbolId> &container,
@@ -0,0 +1,354 @@
+// Copyright 2020 Erik Götzfried
+// Licensed under the Apache License, Version 2.0( the "License" );
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "libpushc/stdafx.h"
+#include "libpushc/Expression.h"
+
+// Visitor passes are structs with static hooks, which are resolved at compile time. Every pass must define:
+//     static constexpr VisitorPassType type; // the pass type (or VisitorPassType::count for custom passes)
+//     static constexpr const char *name; // used in the pass stats
+//     static constexpr bool requires_completed_walk; // whether the previous pass must have visited the whole AST
+//     static constexpr bool parallel; // whether top-level items may be visited concurrently
+//     static bool pre( AstNode &node, AstNode &parent, bool &expect_operand, CrateCtx &c_ctx, TraversalCtx &t_ctx,
+//                      Worker &w_ctx );
+//     static bool post( AstNode &node, CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx );
+// Passes without requires_completed_walk are fused with the previous ones into a single traversal.
+
+// Checks very basic semantic conditions on each expr. Must see the AST before it is transformed
+struct BasicSemanticCheckPass {
+    static constexpr VisitorPassType type = VisitorPassType::BASIC_SEMANTIC_CHECK;
+    static constexpr const char *name = "basic_semantic_check";
+    static constexpr bool requires_completed_walk = false;
+    static constexpr bool parallel = true;
+
+    static bool pre( AstNode &node, AstNode &parent, bool &expect_operand, CrateCtx &c_ctx, TraversalCtx &t_ctx,
+                     Worker &w_ctx ) {
+        return node.basic_semantic_check( c_ctx, w_ctx );
+    }
+    static bool post( AstNode &node, CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx ) { return true; }
+};
+
+// Transforms each expr without symbol information. Requires the whole AST to be checked, because transformations
+// change and drop sub-expressions before the check could see them
+struct FirstTransformationPass {
+    static constexpr VisitorPassType type = VisitorPassType::FIRST_TRANSFORMATION;
+    static constexpr const char *name = "first_transformation";
+    static constexpr bool requires_completed_walk = true;
+    static constexpr bool parallel = true; // only alias statements access the symbol graph (guarded)
+
+    static bool pre( AstNode &node, AstNode &parent, bool &expect_operand, CrateCtx &c_ctx, TraversalCtx &t_ctx,
+                     Worker &w_ctx ) {
+        return node.first_transformation( c_ctx, t_ctx, w_ctx, parent, expect_operand );
+    }
+    static bool post( AstNode &node, CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx ) { return true; }
+};
+
+// Discovers all symbols in declarative scopes. Requires the whole AST to be transformed, because scopes read their
+// (transformed) members and symbols store pointers to exprs, which must not move anymore
+struct SymbolDiscoveryPass {
+    static constexpr VisitorPassType type = VisitorPassType::SYMBOL_DISCOVERY;
+    static constexpr const char *name = "symbol_discovery";
+    static constexpr bool requires_completed_walk = true;
+    static constexpr bool parallel = false; // items may extend symbols of other items and ids must be deterministic
+
+    static bool pre( AstNode &node, AstNode &parent, bool &expect_operand, CrateCtx &c_ctx, TraversalCtx &t_ctx,
+                     Worker &w_ctx ) {
+        return node.symbol_discovery( c_ctx, t_ctx, w_ctx );
+    }
+    static bool post( AstNode &node, CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx ) {
+        return node.post_symbol_discovery( c_ctx, t_ctx, w_ctx );
+    }
+};
+
+// Calls the pre-hooks of the passes in order. NOT A QUERY.
+template <typename... Passes>
+bool visit_pre_hooks( AstNode &node, AstNode &parent, bool &expect_operand, CrateCtx &c_ctx, TraversalCtx &t_ctx,
+                      Worker &w_ctx ) {
+    return ( Passes::pre( node, parent, expect_operand, c_ctx, t_ctx, w_ctx ) && ... );
+}
+
+// Calls the post-hooks of the passes in reverse order. NOT A QUERY.
+template <typename First, typename... Rest>
+bool visit_post_hooks( AstNode &node, CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx ) {
+    if constexpr ( sizeof...( Rest ) > 0 ) {
+        if ( !visit_post_hooks<Rest...>( node, c_ctx, t_ctx, w_ctx ) )
+            return false;
+    }
+    return First::post( node, c_ctx, t_ctx, w_ctx );
+}
+
+// Traverses node and all its sub-expressions depth-first with an explicit stack instead of recursion, so that deeply
+// nested expressions can't exhaust the stack of a worker. Sub-expressions are visited in the order static statements,
+// annotations, named and unnamed children. Every entered node owns a state:
+//     std::optional<State> enter( Node &node, State &parent_state ); // nullopt skips the sub-expressions
+//     void exit( Node &node, State &state, State &parent_state ); // after all sub-expressions were visited
+// The parent state of node itself is root_state. Node may be const. NOT A QUERY.
+template <typename State, typename Node, typename EnterFn, typename ExitFn>
+void walk_ast( Node &node, State &root_state, EnterFn &&enter, ExitFn &&exit ) {
+    struct WorkItem {
+        Node *node;
+        bool exit; // whether the sub-expressions of node have been visited
+    };
+    std::vector<WorkItem> work = { { &node, false } };
+    std::vector<State> states; // states of the entered nodes on the current path
+
+    while ( !work.empty() ) {
+        WorkItem item = work.back();
+        work.pop_back();
+
+        if ( item.exit ) {
+            State state = std::move( states.back() );
+            states.pop_back();
+            exit( *item.node, state, states.empty() ? root_state : states.back() );
+            continue;
+        }
+
+        std::optional<State> state = enter( *item.node, states.empty() ? root_state : states.back() );
+        if ( !state )
+            continue;
+        states.push_back( std::move( *state ) );
+
+        // Sub-expressions are pushed after enter(), because it may transform them. Reversed, to pop them in order
+        work.push_back( { item.node, true } );
+        for ( auto itr = item.node->children.rbegin(); itr != item.node->children.rend(); itr++ )
+            work.push_back( { &*itr, false } );
+        for ( auto itr = item.node->named.rbegin(); itr != item.node->named.rend(); itr++ )
+            work.push_back( { &itr->second, false } );
+        if ( auto *payload = item.node->get_payload() ) {
+            for ( auto itr = payload->annotations.rbegin(); itr != payload->annotations.rend(); itr++ )
+                work.push_back( { &*itr, false } );
+            for ( auto itr = payload->static_statements.rbegin(); itr != payload->static_statements.rend(); itr++ )
+                work.push_back( { &*itr, false } );
+        }
+    }
+}
+
+// Returns the count of node and all its sub-expressions. NOT A QUERY.
+inline size_t count_ast_nodes( const AstNode &node ) {
+    size_t count = 0;
+    u8 root_state = 0; // no state required
+    walk_ast(
+        node, root_state,
+        [&count]( const AstNode &curr, u8 &parent_state ) {
+            count++;
+            return std::optional<u8>( 0 );
+        },
+        []( const AstNode &curr, u8 &state, u8 &parent_state ) {} );
+    return count;
+}
+
+// Returns the names of fused passes joined by "+". NOT A QUERY.
+template <typename... Passes>
+String get_pass_names() {
+    String names;
+    ( ( names += ( names.empty() ? "" : "+" ) + String( Passes::name ) ), ... );
+    return names;
+}
+
+// Visits node and all its sub-expressions in a single traversal. The pre-hooks of all passes are called in order
+// before the sub-expressions are visited, the post-hooks in reverse order after all sub-expressions succeeded. Returns
+// false if any hook failed. NOT A QUERY.
+template <typename... Passes>
+bool visit_fused( AstNode &node, AstNode &parent, bool expect_operand, CrateCtx &c_ctx, TraversalCtx &t_ctx,
+                  Worker &w_ctx ) {
+    struct FusedVisitState {
+        AstNode *node; // parent of the sub-expressions
+        bool expect_operand; // passed to the sub-expressions
+        bool result; // false if a hook of this node or of a sub-expression failed
+    };
+
+    FusedVisitState root_state{ &parent, expect_operand, true };
+    walk_ast(
+        node, root_state,
+        [&]( AstNode &curr, FusedVisitState &parent_state ) -> std::optional<FusedVisitState> {
+            bool curr_expect_operand = parent_state.expect_operand; // hooks may only change it for the sub-expressions
+            if ( !visit_pre_hooks<Passes...>( curr, *parent_state.node, curr_expect_operand, c_ctx, t_ctx, w_ctx ) ) {
+                parent_state.result = false;
+                return std::nullopt;
+            }
+            return FusedVisitState{ &curr, curr_expect_operand, true };
+        },
+        [&]( AstNode &curr, FusedVisitState &state, FusedVisitState &parent_state ) {
+            if ( !state.result || !visit_post_hooks<Passes...>( curr, c_ctx, t_ctx, w_ctx ) )
+                parent_state.result = false;
+        } );
+    return root_state.result;
+}
+
+// Whether the passes succeeded on a range of top-level items and the collected messages
+using VisitedItems = std::pair<bool, std::vector<DeferredMessage>>;
+
+// Visits ranges of top-level items of the crate AST as separate jobs. Each job has its own traversal context
+template <typename... Passes>
+void visit_top_level_items( sptr<CrateCtx> c_ctx, const std::vector<size_t> &boundaries, bool expect_operand,
+                            JobsBuilder &jb, UnitCtx &parent_ctx ) {
+    for ( size_t i = 0; i + 1 < boundaries.size(); i++ ) {
+        size_t begin = boundaries[i];
+        size_t end = boundaries[i + 1];
+        jb.add_free_job<VisitedItems>( [c_ctx, begin, end, expect_operand]( Worker &w_ctx ) {
+            w_ctx.set_curr_job_volatile(); // depends on the AST content
+            VisitedItems result( true, {} );
+            MessageBufferScope buffer_scope( w_ctx, result.second );
+            TraversalCtx t_ctx;
+            auto &root = *c_ctx->ast;
+            for ( size_t j = begin; j < end; j++ ) {
+                if ( !visit_fused<Passes...>( root.children[j], root, expect_operand, *c_ctx, t_ctx, w_ctx ) )
+                    result.first = false;
+            }
+            return result;
+        } );
+    }
+}
+
+// Visits an AST in one traversal per call of walk()
+struct SequentialAstWalker {
+    AstNode &root;
+    CrateCtx &c_ctx;
+    Worker &w_ctx;
+
+    AstNode &get_root() { return root; }
+
+    template <typename... Passes>
+    bool walk() {
+        AstNode dummy_root_parent = { ExprType::none };
+        TraversalCtx t_ctx;
+        return visit_fused<Passes...>( root, dummy_root_parent, false, c_ctx, t_ctx, w_ctx );
+    }
+};
+
+// Visits the crate AST in one traversal per call of walk(). If all passes allow it, the top-level items are visited
+// as parallel jobs and their messages are printed in source order
+struct ParallelAstWalker {
+    sptr<CrateCtx> c_ctx;
+    Worker &w_ctx;
+
+    AstNode &get_root() { return *c_ctx->ast; }
+
+    template <typename... Passes>
+    bool walk() {
+        constexpr size_t min_job_items = 32; // a job has some overhead
+        auto &root = *c_ctx->ast;
+        if constexpr ( !( Passes::parallel && ... ) ) {
+            return SequentialAstWalker{ root, *c_ctx, w_ctx }.template walk<Passes...>();
+        } else {
+            if ( !w_ctx.global_ctx()->get_pref<BoolSV>( PrefType::parallel_parsing ) ||
+                 root.children.size() < 2 * min_job_items )
+                return SequentialAstWalker{ root, *c_ctx, w_ctx }.template walk<Passes...>();
+
+            // Same order as in visit_fused(), but the children are visited concurrently
+            AstNode dummy_root_parent = { ExprType::none };
+            TraversalCtx t_ctx;
+            bool expect_operand = false;
+            if ( !visit_pre_hooks<Passes...>( root, dummy_root_parent, expect_operand, *c_ctx, t_ctx, w_ctx ) )
+                return false;
+
+            bool result = true;
+            if ( auto *payload = root.get_payload() ) {
+                for ( auto &ss : payload->static_statements ) {
+                    if ( !visit_fused<Passes...>( ss, root, expect_operand, *c_ctx, t_ctx, w_ctx ) )
+                        result = false;
+                }
+                for ( auto &a : payload->annotations ) {
+                    if ( !visit_fused<Passes...>( a, root, expect_operand, *c_ctx, t_ctx, w_ctx ) )
+                        result = false;
+                }
+            }
+            for ( auto &sub : root.named ) {
+                if ( !visit_fused<Passes...>( sub.second, root, expect_operand, *c_ctx, t_ctx, w_ctx ) )
+                    result = false;
+            }
+
+            std::vector<size_t> boundaries;
+            for ( size_t i = 0; i < root.children.size(); i += min_job_items )
+                boundaries.push_back( i );
+            if ( root.children.size() - boundaries.back() < min_job_items / 2 )
+                boundaries.pop_back(); // append a small last group to the previous one
+            boundaries.push_back( root.children.size() );
+
+            auto items =
+                w_ctx.do_query( visit_top_level_items<Passes...>, c_ctx, boundaries, expect_operand );
+            for ( auto &job : items->free_jobs() ) {
+                auto item = job->template to<VisitedItems>();
+                for ( auto &message : item.second )
+                    w_ctx.global_ctx()->print_deferred_msg( message );
+                if ( !item.first )
+                    result = false;
+            }
+
+            if ( result )
+                return visit_post_hooks<Passes...>( root, *c_ctx, t_ctx, w_ctx );
+            return result;
+        }
+    }
+};
+
+// Helper to group visitor passes
+template <typename... Passes>
+struct VisitorPassList {};
+
+// Splits a list of passes into traversals. Fused holds the passes of the current traversal
+template <typename Walker, typename Fused, typename... Rest>
+struct VisitorPassScheduler;
+
+template <typename Walker, typename... Fused>
+struct VisitorPassScheduler<Walker, VisitorPassList<Fused...>> {
+    static bool run( Walker &walker, size_t &walk_count ) {
+        if constexpr ( sizeof...( Fused ) == 0 ) {
+            return true;
+        } else {
+            walk_count++;
+            PassTimer timer( walker.w_ctx, get_pass_names<Fused...>() );
+            bool result = walker.template walk<Fused...>();
+            if ( timer.enabled() )
+                timer.add_nodes( count_ast_nodes( walker.get_root() ) );
+            return result;
+        }
+    }
+};
+
+template <typename Walker, typename... Fused, typename Next, typename... Rest>
+struct VisitorPassScheduler<Walker, VisitorPassList<Fused...>, Next, Rest...> {
+    static bool run( Walker &walker, size_t &walk_count ) {
+        if constexpr ( sizeof...( Fused ) > 0 && Next::requires_completed_walk ) {
+            // Finish the current traversal first
+            if ( !VisitorPassScheduler<Walker, VisitorPassList<Fused...>>::run( walker, walk_count ) )
+                return false;
+            return VisitorPassScheduler<Walker, VisitorPassList<Next>, Rest...>::run( walker, walk_count );
+        } else {
+            return VisitorPassScheduler<Walker, VisitorPassList<Fused..., Next>, Rest...>::run( walker, walk_count );
+        }
+    }
+};
+
+// Runs all passes on the AST with as few traversals as possible. Stops after the first failed traversal. Returns
+// false if a pass failed. walk_count is increased for each traversal. NOT A QUERY.
+template <typename... Passes>
+bool run_visitor_passes( AstNode &root, CrateCtx &c_ctx, Worker &w_ctx, size_t &walk_count ) {
+    SequentialAstWalker walker{ root, c_ctx, w_ctx };
+    return VisitorPassScheduler<SequentialAstWalker, VisitorPassList<>, Passes...>::run( walker, walk_count );
+}
+template <typename... Passes>
+bool run_visitor_passes( AstNode &root, CrateCtx &c_ctx, Worker &w_ctx ) {
+    size_t walk_count = 0;
+    return run_visitor_passes<Passes...>( root, c_ctx, w_ctx, walk_count );
+}
+
+// Like run_visitor_passes(), but visits the top-level items of the crate AST concurrently if the passes allow it.
+// NOT A QUERY.
+template <typename... Passes>
+bool run_visitor_passes_parallel( sptr<CrateCtx> c_ctx, Worker &w_ctx ) {
+    size_t walk_count = 0;
+    ParallelAstWalker walker{ c_ctx, w_ctx };
+    return VisitorPassScheduler<ParallelAstWalker, VisitorPassList<>, Passes...>::run( walker, walk_count );
+}
@@ -0,0 +1,259 @@
+// Copyright 2020 Erik Götzfried
+// Licensed under the Apache License, Version 2.0( the "License" );
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libpushc/stdafx.h"
+#include "libpushc/AstCache.h"
+#include "libpushc/Prelude.h"
+#include "libpush/input/SourceStore.h"
+#include <iomanip>
+
+// Identifies AST cache files
+constexpr u8 AST_CACHE_MAGIC[4] = { 'P', 'A', 'S', 'T' };
+
+// Appends values to a blob. Integers are stored as LEB128 varints
+struct BlobWriter {
+    std::vector<u8> &blob;
+    u32 file_id = 0; // id of the only file which positions may refer to
+    bool ok = true;
+
+    void write( u64 value ) {
+        do {
+            u8 byte = value & 0x7f;
+            value >>= 7;
+            blob.push_back( byte | ( value ? 0x80 : 0 ) );
+        } while ( value );
+    }
+    void write( const String &str ) {
+        write( str.size() );
+        blob.insert( blob.end(), str.begin(), str.end() );
+    }
+
+    void write( const PosInfo &pos ) {
+        if ( pos.file && pos.file != file_id )
+            ok = false; // positions in other files can't be restored
+        write( pos.file ? 1 : 0 );
+        write( pos.offset );
+        write( pos.line );
+        write( pos.column );
+        write( pos.length );
+    }
+    void write( const std::vector<AstNode> &nodes ) {
+        write( nodes.size() );
+        for ( auto &node : nodes )
+            write( node );
+    }
+    void write( const AstNodePayload &payload ) {
+        if ( !payload.substitutions.empty() ) {
+            ok = false; // substitutions are not created by the parser
+            return;
+        }
+        write( payload.static_statements );
+        write( payload.annotations );
+        write( payload.original_list.size() );
+        for ( auto &entry : payload.original_list ) {
+            write( static_cast<u64>( entry.source ) );
+            write( entry.index );
+        }
+        write( payload.original_stored );
+        write( payload.literal_string );
+    }
+    void write( const AstNode &node ) {
+        write( static_cast<u64>( node.type ) );
+        write( node.props.get_bits() );
+        write( node.pos_info );
+        write( node.get_payload() ? 1 : 0 );
+        if ( node.get_payload() )
+            write( *node.get_payload() );
+        write( node.precedence );
+        write( node.named.size() );
+        for ( auto &named : node.named ) {
+            write( static_cast<u64>( named.first ) );
+            write( named.second );
+        }
+        write( node.children );
+        write( node.token.str() );
+        write( static_cast<u64>( node.token_type ) );
+        write( node.symbol_name.str() );
+        write( node.symbol );
+        write( node.scope_symbol );
+        write( node.literal_type );
+        write( node.literal_number );
+        write( node.continue_eval );
+        write( static_cast<u64>( node.range_type ) );
+    }
+};
+
+// Reads values from a blob. Every read is bounds-checked, so that malformed blobs are detected
+struct BlobReader {
+    const std::vector<u8> &blob;
+    u32 file_id = 0; // id of the file which positions refer to
+    size_t pos = 0;
+    bool ok = true;
+
+    u64 read() {
+        u64 value = 0;
+        for ( u32 shift = 0; shift < 64; shift += 7 ) {
+            if ( pos >= blob.size() )
+                break;
+            u8 byte = blob[pos++];
+            value |= static_cast<u64>( byte & 0x7f ) << shift;
+            if ( !( byte & 0x80 ) )
+                return value;
+        }
+        ok = false;
+        return 0;
+    }
+    // Reads a value which must be smaller than @param limit
+    template <typename T>
+    T read_below( u64 limit ) {
+        u64 value = read();
+        if ( value >= limit )
+            ok = false;
+        return ok ? static_cast<T>( value ) : T();
+    }
+    // Reads an element count. Each element requires at least one byte
+    size_t read_count() { return read_below<size_t>( blob.size() - pos + 1 ); }
+    String read_str() {
+        size_t size = read_count();
+        if ( !ok || size > blob.size() - pos ) {
+            ok = false;
+            return String();
+        }
+        pos += size;
+        return String( blob.begin() + ( pos - size ), blob.begin() + pos );
+    }
+
+    void read( PosInfo &info ) {
+        info.file = read_below<u8>( 2 ) ? file_id : 0;
+        info.offset = read_below<u32>( UINT32_MAX + 1ull );
+        info.line = read_below<u32>( UINT32_MAX + 1ull );
+        info.column = read_below<u32>( UINT32_MAX + 1ull );
+        info.length = read_below<u32>( UINT32_MAX + 1ull );
+    }
+    void read( std::vector<AstNode> &nodes ) {
+        nodes.resize( read_count() );
+        for ( size_t i = 0; i < nodes.size() && ok; i++ )
+            read( nodes[i] );
+    }
+    void read( AstNodePayload &payload ) {
+        read( payload.static_statements );
+        read( payload.annotations );
+        payload.original_list.resize( read_count() );
+        for ( auto &entry : payload.original_list ) {
+            entry.source = read_below<OriginalListEntry::Source>( 3 );
+            entry.index = read_below<u32>( UINT32_MAX + 1ull );
+        }
+        read( payload.original_stored );
+        payload.literal_string = read_str();
+    }
+    void read( AstNode &node ) {
+        node.type = read_below<ExprType>( static_cast<u64>( ExprType::count ) );
+        node.props = ExprPropertySet::from_bits( read_below<u32>( 1ull << static_cast<u32>( ExprProperty::count ) ) );
+        read( node.pos_info );
+        if ( read_below<u8>( 2 ) )
+            read( node.mutable_payload() );
+        node.precedence = read_below<u32>( UINT32_MAX + 1ull );
+        size_t named_count = read_count();
+        for ( size_t i = 0; i < named_count && ok; i++ ) {
+            auto child = read_below<AstChild>( static_cast<u64>( AstChild::count ) );
+            read( node.named[child] );
+        }
+        read( node.children );
+        node.token = InternedString( read_str() );
+        node.token_type = read_below<Token::Type>( static_cast<u64>( Token::Type::count ) + 1 );
+        node.symbol_name = InternedString( read_str() );
+        node.symbol = read_below<SymbolId>( UINT32_MAX + 1ull );
+        node.scope_symbol = read_below<SymbolId>( UINT32_MAX + 1ull );
+        node.literal_type = read_below<TypeId>( UINT32_MAX + 1ull );
+        node.literal_number = read();
+        node.continue_eval = read_below<u8>( 2 );
+        node.range_type = read_below<Operator::RangeOperatorType>(
+            static_cast<u64>( Operator::RangeOperatorType::count ) + 1 );
+    }
+};
+
+bool serialize_ast( const AstNode &ast, const String &file, std::vector<u8> &blob ) {
+    BlobWriter writer{ blob, SourceStore::get_global()->get_file_id( make_shared<String>( file ) ) };
+    writer.write( ast );
+    return writer.ok;
+}
+
+bool deserialize_ast( const std::vector<u8> &blob, sptr<String> file, AstNode &ast ) {
+    BlobReader reader{ blob, SourceStore::get_global()->get_file_id( file ) };
+    reader.read( ast );
+    return reader.ok && reader.pos == blob.size();
+}
+
+u64 get_ast_cache_key( const String &source, const PreludeConfig &conf ) {
+    std::stringstream ss;
+    ss << PUSH_VERSION_MAJOR << '.' << PUSH_VERSION_MINOR << '.' << PUSH_VERSION_PATCH << ','
+       << AST_CACHE_FORMAT_VERSION << conf;
+    return std::hash<String>{}( ss.str() ) * 31 + std::hash<String>{}( source );
+}
+
+// Returns the path of a cache entry
+fs::path get_ast_cache_path( const String &cache_dir, u64 key ) {
+    std::stringstream ss;
+    ss << std::hex << std::setw( 16 ) << std::setfill( '0' ) << key << ".ast";
+    return fs::path( cache_dir ) / ss.str();
+}
+
+bool load_cached_ast( const String &cache_dir, u64 key, sptr<String> file, AstNode &ast ) {
+    std::ifstream stream( get_ast_cache_path( cache_dir, key ), std::ios_base::binary );
+    if ( !stream )
+        return false;
+    std::vector<u8> data( ( std::istreambuf_iterator<char>( stream ) ), std::istreambuf_iterator<char>() );
+
+    // Header: magic, format version and the full key (the file name could collide)
+    BlobReader header{ data };
+    if ( data.size() < sizeof( AST_CACHE_MAGIC ) ||
+         !std::equal( std::begin( AST_CACHE_MAGIC ), std::end( AST_CACHE_MAGIC ), data.begin() ) )
+        return false;
+    header.pos = sizeof( AST_CACHE_MAGIC );
+    if ( header.read() != AST_CACHE_FORMAT_VERSION || header.read() != key || !header.ok )
+        return false;
+
+    data.erase( data.begin(), data.begin() + header.pos );
+    AstNode cached;
+    if ( !deserialize_ast( data, file, cached ) )
+        return false;
+    ast = std::move( cached );
+    return true;
+}
+
+bool store_cached_ast( const String &cache_dir, u64 key, const AstNode &ast, const String &file ) {
+    std::vector<u8> data( std::begin( AST_CACHE_MAGIC ), std::end( AST_CACHE_MAGIC ) );
+    BlobWriter header{ data };
+    header.write( AST_CACHE_FORMAT_VERSION );
+    header.write( key );
+    if ( !serialize_ast( ast, file, data ) )
+        return false;
+
+    // Write into a temporary file first, so that other compiler instances never read a partial entry
+    std::error_code ec;
+    fs::create_directories( cache_dir, ec );
+    auto path = get_ast_cache_path( cache_dir, key );
+    auto tmp_path = path;
+    tmp_path += "." + to_string( std::hash<std::thread::id>{}( std::this_thread::get_id() ) ) + ".tmp";
+    {
+        std::ofstream stream( tmp_path, std::ios_base::binary | std::ios_base::trunc );
+        if ( !stream.write( reinterpret_cast<const char *>( data.data() ), data.size() ) )
+            return false;
+    }
+    fs::rename( tmp_path, path, ec );
+    if ( ec ) {
+        fs::remove( tmp_path, ec );
+        return false;
+    }
+    return true;
+}
@@ -13,11 +13,13 @@
 
 #include "libpushc/stdafx.h"
 #include "libpushc/AstParser.h"
+#include "libpushc/AstCache.h"
 #include "libpushc/Prelude.h"
 #include "libpushc/Expression.h"
 #include "libpushc/Util.h"
 #include "libpushc/SymbolParser.h"
 #include "libpushc/SymbolUtil.h"
+#include "libpushc/VisitorPasses.h"
 
 using TT = Token::Type;
 
@@ -46,6 +48,8 @@ Token expect_token_or_comment( TT type, SourceInput &input, Worker &w_ctx ) {
 // Checks if a prelude is defined and loads the proper prelude.
 // Should be called at the beginning of a file
 void select_prelude( SourceInput &input, Worker &w_ctx ) {
+    PassTimer timer( w_ctx, "select_prelude" );
+
     // Load prelude-prelude first
     w_ctx.unit_ctx()->prelude_conf =
         w_ctx.do_query( load_prelude, make_shared<String>( "prelude" ) )->jobs.front()->to<PreludeConfig>();
@@ -97,14 +101,114 @@ void select_prelude( SourceInput &input, Worker &w_ctx ) {
     input.configure( w_ctx.unit_ctx()->prelude_conf.token_conf );
 }
 
+// Expressions which are shared by multiple parse paths. Segments build a graph-structured stack, so that ambiguous
+// paths only store their divergent expressions. A segment is never changed after it has been created
+struct SharedPathSegment {
+    sptr<SharedPathSegment> parent;
+    size_t parent_size = 0; // amount of expressions used from the parent
+    std::vector<AstNode> exprs; // expressions following the parent expressions
+};
+
+// A parse path which consists of a shared prefix and its own expressions
+struct ParsePath {
+    sptr<SharedPathSegment> prefix;
+    size_t prefix_size = 0; // amount of expressions used from the prefix
+    std::vector<AstNode> suffix; // expressions only owned by this path
+    std::vector<std::pair<u32, u32>> precedences; // precedence list as class-from-pairs
+
+    size_t size() const { return prefix_size + suffix.size(); }
+    bool empty() const { return size() == 0; }
+    // Whether the expression at idx is shared with other paths and therefore must not be changed
+    bool is_shared( size_t idx ) const { return idx < prefix_size; }
+
+    // Returns the expression at idx
+    AstNode &at( size_t idx ) {
+        if ( idx >= prefix_size )
+            return suffix[idx - prefix_size];
+        SharedPathSegment *segment = prefix.get();
+        while ( idx < segment->parent_size )
+            segment = segment->parent.get();
+        return segment->exprs[idx - segment->parent_size];
+    }
+
+    // Returns the last expression, which can be changed
+    AstNode &mutable_back() {
+        if ( suffix.empty() ) {
+            suffix.push_back( at( prefix_size - 1 ) );
+            prefix_size--;
+        }
+        return suffix.back();
+    }
+
+    // Removes expressions from the end until the path has the new size
+    void shrink( size_t new_size ) {
+        if ( new_size >= prefix_size ) {
+            suffix.resize( new_size - prefix_size );
+        } else {
+            suffix.clear();
+            prefix_size = new_size;
+        }
+    }
+
+    // Moves the own expressions into a new shared segment. Afterwards the path can be copied cheaply
+    void share() {
+        if ( suffix.empty() )
+            return;
+        auto segment = make_shared<SharedPathSegment>();
+        segment->parent = prefix;
+        segment->parent_size = prefix_size;
+        segment->exprs = std::move( suffix );
+        prefix = segment;
+        prefix_size = segment->parent_size + segment->exprs.size();
+        suffix.clear();
+    }
+
+    // Creates the full expression list of this path. Expressions of segments which are only owned by this path are
+    // moved, shared ones are copied. The path is empty afterwards
+    std::vector<AstNode> flatten() {
+        struct UsedSegment {
+            SharedPathSegment *segment;
+            size_t used; // used size of the path up to the end of this segment
+            bool owned; // whether no other path refers to this segment
+        };
+        std::vector<UsedSegment> segments;
+        SharedPathSegment *segment = prefix.get();
+        size_t used = prefix_size;
+        bool owned = prefix.use_count() == 1;
+        while ( segment && used > 0 ) {
+            segments.push_back( { segment, used, owned } );
+            used = std::min( used, segment->parent_size );
+            owned = owned && segment->parent.use_count() == 1; // older segments are shared if a newer one is
+            segment = segment->parent.get();
+        }
+
+        std::vector<AstNode> result;
+        result.reserve( size() );
+        for ( auto itr = segments.rbegin(); itr != segments.rend(); itr++ ) {
+            auto &exprs = itr->segment->exprs;
+            for ( size_t i = itr->segment->parent_size; i < itr->used; i++ ) {
+                if ( itr->owned )
+                    result.push_back( std::move( exprs[i - itr->segment->parent_size] ) );
+                else
+                    result.push_back( exprs[i - itr->segment->parent_size] );
+            }
+        }
+        result.insert( result.end(), std::make_move_iterator( suffix.begin() ),
+                       std::make_move_iterator( suffix.end() ) );
+
+        prefix = nullptr;
+        prefix_size = 0;
+        suffix.clear();
+        return result;
+    }
+};
+
 // Parses a scope into the ast. Used recursively. @param last_token may be nullptr
 AstNode parse_scope( sptr<SourceInput> &input, Worker &w_ctx, CrateCtx &c_ctx, TT end_token, Token *last_token ) {
     auto &conf = w_ctx.unit_ctx()->prelude_conf;
-    std::vector<std::pair<std::vector<AstNode>, std::vector<std::pair<u32, u32>>>>
-        expr_lists; // the paths with their expression lists and precedence lists as class-from-pairs
-    expr_lists.push_back( std::make_pair(
-        std::vector<AstNode>(),
-        std::vector<std::pair<u32, u32>>{ std::make_pair( UINT32_MAX, UINT32_MAX ) } ) ); // add a starting path
+    std::vector<ParsePath> expr_lists; // the paths
+    expr_lists.emplace_back(); // add a starting path
+    expr_lists.back().precedences.push_back( std::make_pair( UINT32_MAX, UINT32_MAX ) );
 
     // Iterate through all tokens in this scope
     while ( true ) {
@@ -132,9 +236,10 @@ AstNode parse_scope( sptr<SourceInput> &input, Worker &w_ctx, CrateCtx &c_ctx, T
                 &t );
         } else if ( t.type == TT::identifier ) {
             input->get_token(); // consume
-            if ( c_ctx.literals_map.find( t.content ) != c_ctx.literals_map.end() ) {
+            // Top-level items are parsed concurrently, so the shared map is only read
+            if ( auto literal_itr = c_ctx.literals_map.find( t.content ); literal_itr != c_ctx.literals_map.end() ) {
                 // Found a special literal keyword
-                auto literal = c_ctx.literals_map[t.content];
+                auto literal = literal_itr->second;
                 auto expr = AstNode{ ExprType::numeric_literal };
                 expr.generate_new_props();
                 expr.literal_type = literal.first;
@@ -142,16 +247,16 @@ AstNode parse_scope( sptr<SourceInput> &input, Worker &w_ctx, CrateCtx &c_ctx, T
                 TypeMemSize size = c_ctx.type_table[literal.first].additional_mem_size;
                 expr.literal_number = literal.second;
 
-                expr.pos_info = { t.file, t.line, t.column, t.length };
+                expr.pos_info = t.pos_info();
 
-                add_to_all_paths = expr;
+                add_to_all_paths = std::move( expr );
             } else {
                 // Normal identifier/symbol
                 auto expr = AstNode{ ExprType::atomic_symbol };
                 expr.generate_new_props();
-                expr.symbol_name = t.content;
-                expr.pos_info = { t.file, t.line, t.column, t.length };
-                add_to_all_paths = expr;
+                expr.symbol_name = InternedString( t.content );
+                expr.pos_info = t.pos_info();
+                add_to_all_paths = std::move( expr );
             }
         } else if ( t.type == TT::number ) {
             input->get_token(); // consume
@@ -162,13 +267,13 @@ AstNode parse_scope( sptr<SourceInput> &input, Worker &w_ctx, CrateCtx &c_ctx, T
             Number val = stoull( t.content );
             expr.literal_number = val;
 
-            expr.pos_info = { t.file, t.line, t.column, t.length };
+            expr.pos_info = t.pos_info();
 
-            add_to_all_paths = expr;
+            add_to_all_paths = std::move( expr );
         } else if ( t.type == TT::stat_divider ) {
             input->get_token(); // consume
             for ( auto &expr_list : expr_lists ) {
-                if ( expr_list.first.empty() ) {
+                if ( expr_list.empty() ) {
                     if ( &expr_list == &expr_lists.front() ) { // only error once
                         w_ctx.print_msg<MessageType::err_semicolon_without_meaning>(
                             MessageInfo( t, 0, FmtStr::Color::Red ) );
@@ -176,35 +281,40 @@ AstNode parse_scope( sptr<SourceInput> &input, Worker &w_ctx, CrateCtx &c_ctx, T
                 } else {
                     auto expr = AstNode{ ExprType::single_completed };
                     expr.generate_new_props();
-                    expr.pos_info = { t.file, t.line, t.column, t.length };
-                    expr.children.push_back( expr_list.first.back() );
-                    expr_list.first.back() = expr;
+                    expr.pos_info = t.pos_info();
+                    auto &last_expr = expr_list.mutable_back();
+                    expr.children.push_back( std::move( last_expr ) );
+                    last_expr = std::move( expr );
                 }
             }
         } else if ( t.type == TT::string_begin ) {
             auto expr = AstNode{ ExprType::string_literal };
             expr.generate_new_props();
-            expr.literal_string = parse_string( *input, w_ctx );
+            expr.mutable_payload().literal_string = parse_string( *input, w_ctx );
             expr.literal_type = c_ctx.str_type;
-            expr.pos_info = { t.file, t.line, t.column, t.length };
-            add_to_all_paths = expr;
+            expr.pos_info = t.pos_info();
+            add_to_all_paths = std::move( expr );
         } else {
             input->get_token(); // consume
             add_to_all_paths.type = ExprType::token;
-            add_to_all_paths.token = t;
-            add_to_all_paths.pos_info = PosInfo{ t.file, t.line, t.column, t.length };
+            add_to_all_paths.token = InternedString( t.content );
+            add_to_all_paths.token_type = t.type;
+            add_to_all_paths.pos_info = t.pos_info();
             add_to_all_paths.generate_new_props();
         }
 
         // Update paths with new token
         if ( add_to_all_paths.type != ExprType::none ) {
-            for ( auto &expr_list : expr_lists ) {
-                expr_list.first.push_back( add_to_all_paths );
+            for ( size_t i = 0; i + 1 < expr_lists.size(); i++ ) {
+                expr_lists[i].suffix.push_back( add_to_all_paths );
             }
+            expr_lists.back().suffix.push_back( std::move( add_to_all_paths ) ); // the last path doesn't need a copy
         }
 
         // Test new token for all paths
         u32 fold_counter = 0;
+        std::vector<size_t> candidate_rules;
+        std::vector<AstNode *> rev_deep_expr_list, stst_set;
         size_t old_paths_count = expr_lists.size();
         for ( size_t i = 0; i < old_paths_count; i++ ) {
             auto *expr_list = &expr_lists[i];
@@ -214,12 +324,19 @@ AstNode parse_scope( sptr<SourceInput> &input, Worker &w_ctx, CrateCtx &c_ctx, T
             size_t skip_ctr = 0; // skip already parsed token
             do {
                 recheck = false;
-                SyntaxRule *best_rule = nullptr;
-                std::vector<AstNode> best_rule_rev_deep_expr_list;
-                std::vector<AstNode> best_rule_stst_set;
+                const SyntaxRule *best_rule = nullptr;
+                std::vector<AstNode *> best_rule_rev_deep_expr_list; // references into the current path
+                std::vector<AstNode *> best_rule_stst_set;
                 size_t best_rule_cutout_ctr;
-                // Check each syntax rule
-                for ( auto &rule : c_ctx.rules ) {
+                // Check each syntax rule which could match the newest expression
+                size_t newest_idx = expr_list->size();
+                while ( newest_idx > 0 && expr_list->at( newest_idx - 1 ).type == ExprType::static_statement )
+                    newest_idx--;
+                c_ctx.syntax_table->index.collect_candidates(
+                    c_ctx.syntax_table->rules, ( newest_idx > 0 ? &expr_list->at( newest_idx - 1 ) : nullptr ),
+                    expr_list->size() - newest_idx >= skip_ctr, candidate_rules );
+                for ( auto rule_idx : candidate_rules ) {
+                    auto &rule = c_ctx.syntax_table->rules[rule_idx];
                     bool use_bias =
                         ( best_rule ? ( rule.prec_bias != NO_BIAS_VALUE && best_rule->prec_bias != NO_BIAS_VALUE &&
                                         rule.prec_bias != best_rule->prec_bias )
@@ -229,14 +346,14 @@ AstNode parse_scope( sptr<SourceInput> &input, Worker &w_ctx, CrateCtx &c_ctx, T
                         u8 rule_length = rule.expr_list.size();
 
                         // Prepare backtracing
-                        std::vector<AstNode> rev_deep_expr_list;
-                        std::vector<AstNode> stst_set;
+                        rev_deep_expr_list.clear();
+                        stst_set.clear();
                         size_t cutout_ctr = 0;
-                        for ( auto expr_itr = expr_list->first.rbegin();
-                              expr_itr != expr_list->first.rend() && rev_deep_expr_list.size() < rule_length;
-                              expr_itr++ ) {
+                        for ( size_t idx = expr_list->size(); idx > 0 && rev_deep_expr_list.size() < rule_length;
+                              idx-- ) {
+                            auto *expr_itr = &expr_list->at( idx - 1 );
                             if ( expr_itr->type == ExprType::static_statement ) { // is a static statement
-                                stst_set.push_back( *expr_itr );
+                                stst_set.push_back( expr_itr );
                             } else {
                                 if ( cutout_ctr >= skip_ctr && rev_deep_expr_list.size() < rule_length &&
                                      expr_itr->has_prop( ExprProperty::separable ) &&
@@ -246,7 +363,7 @@ AstNode parse_scope( sptr<SourceInput> &input, Worker &w_ctx, CrateCtx &c_ctx, T
                                     expr_itr->split_prepend_recursively( rev_deep_expr_list, stst_set, rule.precedence,
                                                                          rule.ltr, rule_length );
                                 } else { // Don't split expr
-                                    rev_deep_expr_list.push_back( *expr_itr );
+                                    rev_deep_expr_list.push_back( expr_itr );
                                 }
                             }
                             cutout_ctr++;
@@ -255,8 +372,8 @@ AstNode parse_scope( sptr<SourceInput> &input, Worker &w_ctx, CrateCtx &c_ctx, T
                         // Check if syntax matches
                         if ( rule.matches_reversed( rev_deep_expr_list ) ) {
                             best_rule = &rule;
-                            best_rule_rev_deep_expr_list = rev_deep_expr_list;
-                            best_rule_stst_set = stst_set;
+                            std::swap( best_rule_rev_deep_expr_list, rev_deep_expr_list );
+                            std::swap( best_rule_stst_set, stst_set );
                             best_rule_cutout_ctr = cutout_ctr;
                         }
                     }
@@ -264,39 +381,61 @@ AstNode parse_scope( sptr<SourceInput> &input, Worker &w_ctx, CrateCtx &c_ctx, T
 
                 // Apply rule
                 if ( best_rule && ( !best_rule->ambiguous || skip_ctr <= 0 ) ) {
+                    // Take the matched expressions out of the path. Ambiguous rules keep the original path alive and
+                    // other paths may share the expressions, so only then the expressions must be copied
+                    bool copy_exprs = best_rule->ambiguous ||
+                                      expr_list->is_shared( expr_list->size() - best_rule_cutout_ctr );
+                    std::vector<AstNode> rev_deep_nodes, stst_nodes;
+                    rev_deep_nodes.reserve( best_rule_rev_deep_expr_list.size() );
+                    stst_nodes.reserve( best_rule_stst_set.size() );
+                    for ( auto *expr : best_rule_rev_deep_expr_list ) {
+                        if ( copy_exprs )
+                            rev_deep_nodes.push_back( *expr );
+                        else
+                            rev_deep_nodes.push_back( std::move( *expr ) );
+                    }
+                    for ( auto *expr : best_rule_stst_set ) {
+                        if ( copy_exprs )
+                            stst_nodes.push_back( *expr );
+                        else
+                            stst_nodes.push_back( std::move( *expr ) );
+                    }
+
                     bool update_precedence_to_path = false;
-                    if ( best_rule->ambiguous ) { // copy the not-changed path
+                    if ( best_rule->ambiguous ) { // fork the not-changed path, which shares all expressions
+                        expr_list->share();
                         expr_lists.push_back( *expr_list );
                         expr_list = &expr_lists[i]; // prevent interator invalidation
-                        expr_lists.back().second.push_back( std::make_pair( UINT32_MAX, best_rule->prec_class.first ) );
-                        expr_list->second.push_back(
+                        expr_lists.back().precedences.push_back(
+                            std::make_pair( UINT32_MAX, best_rule->prec_class.first ) );
+                        expr_list->precedences.push_back(
                             std::make_pair( best_rule->prec_class.first, best_rule->prec_class.first ) );
                     } else if ( old_paths_count > 1 ) {
-                        if ( expr_list->second.back().second == best_rule->prec_class.second &&
-                             expr_list->second.back().first == UINT32_MAX ) {
+                        if ( expr_list->precedences.back().second == best_rule->prec_class.second &&
+                             expr_list->precedences.back().first == UINT32_MAX ) {
                             // path precedence update, because class matches
-                            expr_list->second.back().first = best_rule->prec_class.first;
+                            expr_list->precedences.back().first = best_rule->prec_class.first;
                             update_precedence_to_path = true;
                             fold_counter++;
                         }
                     }
 
-                    expr_list->first.resize( expr_list->first.size() - best_rule_cutout_ctr );
-                    expr_list->first.insert( expr_list->first.end(), best_rule_rev_deep_expr_list.rbegin(),
-                                             best_rule_rev_deep_expr_list.rend() - best_rule->expr_list.size() );
-                    best_rule_rev_deep_expr_list.erase(
-                        best_rule_rev_deep_expr_list.begin() + best_rule->expr_list.size(),
-                        best_rule_rev_deep_expr_list.end() );
-                    std::reverse( best_rule_rev_deep_expr_list.begin(), best_rule_rev_deep_expr_list.end() );
-                    auto result_expr = best_rule->create( best_rule_rev_deep_expr_list, w_ctx );
-                    result_expr.static_statements = best_rule_stst_set;
+                    expr_list->shrink( expr_list->size() - best_rule_cutout_ctr );
+                    expr_list->suffix.insert(
+                        expr_list->suffix.end(), std::make_move_iterator( rev_deep_nodes.rbegin() ),
+                        std::make_move_iterator( rev_deep_nodes.rend() - best_rule->expr_list.size() ) );
+                    rev_deep_nodes.erase( rev_deep_nodes.begin() + best_rule->expr_list.size(), rev_deep_nodes.end() );
+                    std::reverse( rev_deep_nodes.begin(), rev_deep_nodes.end() );
+                    auto result_expr = best_rule->create( rev_deep_nodes, w_ctx );
+                    if ( !stst_nodes.empty() )
+                        result_expr.mutable_payload().static_statements = std::move( stst_nodes );
 
                     if ( result_expr.has_prop( ExprProperty::separable ) &&
                          update_precedence_to_path ) { // path precedence overwrites normal precedence
                         result_expr.precedence = best_rule->prec_class.first;
                     }
 
-                    expr_list->first.push_back( result_expr );
+                    expr_list->suffix.push_back( std::move( result_expr ) );
 
                     skip_ctr = 1; // 1 will always be desired even though more could technically be skipped
                     recheck = true;
@@ -312,14 +451,15 @@ AstNode parse_scope( sptr<SourceInput> &input, Worker &w_ctx, CrateCtx &c_ctx, T
                          to_string( expr_lists.size() ) + " paths." );
             } else {
                 for ( size_t i = 0; i < half_path_count; i++ ) {
-                    if ( expr_lists[i].second.back().first > expr_lists[i + half_path_count].second.back().first ) {
+                    if ( expr_lists[i].precedences.back().first >
+                         expr_lists[i + half_path_count].precedences.back().first ) {
                         // take the second path
-                        expr_lists[i] = expr_lists[i + half_path_count];
+                        expr_lists[i] = std::move( expr_lists[i + half_path_count] );
                     }
                     // otherwise take the first path implicitly
 
                     // Shrink the path length
-                    expr_lists[i].second.pop_back();
+                    expr_lists[i].precedences.pop_back();
                 }
                 expr_lists.resize( half_path_count );
             }
@@ -332,36 +472,37 @@ AstNode parse_scope( sptr<SourceInput> &input, Worker &w_ctx, CrateCtx &c_ctx, T
     auto *best_list = &expr_lists.front();
     for ( auto &list : expr_lists ) {
         bool better = true, equal = true;
-        for ( int i = 0; better && i < list.second.size(); i++ ) { // assuming all precedence lists have the same length
-            if ( list.second[i] > best_list->second[i] )
+        // assuming all precedence lists have the same length
+        for ( int i = 0; better && i < list.precedences.size(); i++ ) {
+            if ( list.precedences[i] > best_list->precedences[i] )
                 better = false;
-            if ( list.second[i] != best_list->second[i] )
+            if ( list.precedences[i] != best_list->precedences[i] )
                 equal = false;
         }
         if ( better && !equal )
             best_list = &list; // found a better path
     }
-    auto &expr_list = best_list->first;
+    auto expr_list = best_list->flatten();
 
     // Create block
     if ( end_token == TT::eof ) {
         auto block = AstNode{ ExprType::decl_scope };
         block.generate_new_props();
-        block.children = expr_list;
+        block.children = std::move( expr_list );
         return block;
     } else if ( end_token == TT::block_end ) {
-        PosInfo pos_info = PosInfo{ last_token->file, last_token->line, last_token->column, last_token->length };
+        PosInfo pos_info = last_token->pos_info();
         if ( expr_list.size() == 1 && expr_list.front().type == ExprType::comma_list ) { // set
             auto block = AstNode{ ExprType::set };
             block.generate_new_props();
             block.pos_info = pos_info;
-            block.children = expr_list.front().children;
+            block.children = std::move( expr_list.front().children );
             return block;
         } else { // block
             auto block = AstNode{ ExprType::block };
             block.generate_new_props();
             block.pos_info = pos_info;
-            block.children = expr_list;
+            block.children = std::move( expr_list );
             return block;
         }
     } else if ( end_token == TT::term_end ) {
@@ -372,9 +513,7 @@ AstNode parse_scope( sptr<SourceInput> &input, Worker &w_ctx, CrateCtx &c_ctx, T
             block.generate_new_props();
             return block;
         } else { // normal term or tuple
-            PosInfo pos_info = merge_pos_infos(
-                PosInfo{ last_token->file, last_token->line, last_token->column, last_token->length },
-                PosInfo{ ending_token.file, ending_token.line, ending_token.column, ending_token.length } );
+            PosInfo pos_info = merge_pos_infos( last_token->pos_info(), ending_token.pos_info() );
 
             if ( expr_list.empty() ) { // Unit type
                 auto block = AstNode{ ExprType::unit };
@@ -385,23 +524,21 @@ AstNode parse_scope( sptr<SourceInput> &input, Worker &w_ctx, CrateCtx &c_ctx, T
                 auto block = AstNode{ ExprType::tuple };
                 block.generate_new_props();
                 block.pos_info = pos_info;
-                block.children = expr_list.front().children;
+                block.children = std::move( expr_list.front().children );
                 return block;
             } else { // term
                 auto block = AstNode{ ExprType::term };
                 block.generate_new_props();
                 block.pos_info = pos_info;
-                block.children = expr_list;
+                block.children = std::move( expr_list );
                 return block;
             }
         }
     } else if ( end_token == TT::array_end ) {
         auto block = AstNode{ ExprType::array_specifier };
         block.generate_new_props();
-        block.pos_info = merge_pos_infos(
-            PosInfo{ last_token->file, last_token->line, last_token->column, last_token->length },
-            PosInfo{ ending_token.file, ending_token.line, ending_token.column, ending_token.length } );
-        block.children = expr_list;
+        block.pos_info = merge_pos_infos( last_token->pos_info(), ending_token.pos_info() );
+        block.children = std::move( expr_list );
         return block;
     } else {
         LOG_ERR( "Try to parse a block which is no block" );
@@ -409,7 +546,91 @@ AstNode parse_scope( sptr<SourceInput> &input, Worker &w_ctx, CrateCtx &c_ctx, T
     }
 }
 
+std::vector<size_t> find_top_level_items( const TokenBuffer &tokens, size_t begin ) {
+    size_t eof = tokens.size() - 1;
+    std::vector<size_t> boundaries = { begin };
+    i64 depth = 0;
+    for ( size_t i = begin; i < eof; i++ ) {
+        if ( tokens.level( i ) != TokenLevel::normal )
+            continue;
+        auto type = tokens.type( i );
+        if ( type == TT::block_begin || type == TT::term_begin || type == TT::array_begin ) {
+            depth++;
+        } else if ( type == TT::block_end || type == TT::term_end || type == TT::array_end ) {
+            if ( --depth < 0 )
+                return { begin, eof }; // unbalanced, so the file is parsed as a whole
+        }
+
+        // An identifier can't continue the previous item after a divider or a block (unlike "else" etc.)
+        if ( depth == 0 && ( type == TT::stat_divider || type == TT::block_end ) && i + 1 < eof &&
+             tokens.type( i + 1 ) == TT::identifier && tokens.level( i + 1 ) == TokenLevel::normal ) {
+            boundaries.push_back( i + 1 );
+        }
+    }
+    boundaries.push_back( eof );
+    return boundaries;
+}
+
+// Parsed expressions of a top-level item and the messages which were created while parsing it
+using ParsedItem = std::pair<std::vector<AstNode>, std::vector<DeferredMessage>>;
+
+void parse_top_level_items( sptr<BufferedInput> input, sptr<CrateCtx> c_ctx, const std::vector<size_t> &boundaries,
+                            JobsBuilder &jb, UnitCtx &parent_ctx ) {
+    for ( size_t i = 0; i + 1 < boundaries.size(); i++ ) {
+        size_t begin = boundaries[i];
+        size_t end = boundaries[i + 1];
+        jb.add_free_job<ParsedItem>( [input, c_ctx, begin, end]( Worker &w_ctx ) {
+            w_ctx.set_curr_job_volatile(); // depends on the input content
+            ParsedItem result;
+            MessageBufferScope buffer_scope( w_ctx, result.second );
+            sptr<SourceInput> item_input = input->slice( begin, end, w_ctx.shared_from_this() );
+            result.first = std::move( parse_scope( item_input, w_ctx, *c_ctx, TT::eof, nullptr ).children );
+            return result;
+        } );
+    }
+}
+
+AstNode parse_global_scope( sptr<SourceInput> &input, Worker &w_ctx, sptr<CrateCtx> c_ctx ) {
+    auto buffered_input = std::dynamic_pointer_cast<BufferedInput>( input );
+    std::vector<size_t> boundaries;
+    if ( buffered_input && w_ctx.global_ctx()->get_pref<BoolSV>( PrefType::parallel_parsing ) ) {
+        consume_comment( *input );
+        auto items = find_top_level_items( *buffered_input->get_buffer(), buffered_input->mark() );
+
+        // Small items are grouped together, because a job has some overhead
+        constexpr size_t min_job_tokens = 1024;
+        for ( size_t i = 0; i + 1 < items.size(); i++ ) {
+            if ( boundaries.empty() || items[i] - boundaries.back() >= min_job_tokens )
+                boundaries.push_back( items[i] );
+        }
+        if ( !boundaries.empty() && items.back() - boundaries.back() < min_job_tokens / 2 && boundaries.size() > 1 )
+            boundaries.pop_back(); // append a small last group to the previous one
+        boundaries.push_back( items.back() );
+    }
+    if ( boundaries.size() <= 2 )
+        return parse_scope( input, w_ctx, *c_ctx, TT::eof, nullptr );
+
+    auto items = w_ctx.do_query( parse_top_level_items, buffered_input, c_ctx, boundaries );
+
+    // Merge the items and their messages in source order
+    auto block = AstNode{ ExprType::decl_scope };
+    block.generate_new_props();
+    for ( auto &job : items->free_jobs() ) {
+        auto item = job->to<ParsedItem>();
+        for ( auto &message : item.second )
+            w_ctx.global_ctx()->print_deferred_msg( message );
+        block.children.insert( block.children.end(), std::make_move_iterator( item.first.begin() ),
+                               std::make_move_iterator( item.first.end() ) );
+    }
+    buffered_input->reset( buffered_input->get_buffer()->size() - 1 ); // continue at eof
+    input->get_token(); // consume eof
+    return block;
+}
+
 void load_base_types( CrateCtx &c_ctx, Worker &w_ctx, PreludeConfig &cfg ) {
+    PassTimer timer( w_ctx, "load_base_types" );
+    size_t old_symbol_count = c_ctx.symbol_graph.size();
+
     // Internal types
     c_ctx.type_type = create_new_internal_type( c_ctx, w_ctx );
     c_ctx.struct_type = create_new_internal_type( c_ctx, w_ctx );
@@ -419,7 +640,7 @@ void load_base_types( CrateCtx &c_ctx, Worker &w_ctx, PreludeConfig &cfg ) {
 
     // Most basic types/traits
     SymbolId new_symbol = create_new_global_symbol_from_name_chain(
-        c_ctx, w_ctx, make_shared<std::vector<SymbolIdentifier>>( 1, SymbolIdentifier{ "()" } ) );
+        c_ctx, w_ctx, make_shared<std::vector<SymbolIdentifier>>( 1, SymbolIdentifier{ InternedString( "()" ) } ) );
     c_ctx.unit_type = create_new_type( c_ctx, w_ctx, new_symbol );
 
     new_symbol = create_new_global_symbol_from_name_chain(
@@ -482,6 +703,7 @@ void load_base_types( CrateCtx &c_ctx, Worker &w_ctx, PreludeConfig &cfg ) {
                                    .front();
         c_ctx.literals_map[lit.first] = std::make_pair( type_symbol, lit.second.second );
     }
+    timer.add_nodes( c_ctx.symbol_graph.size() - old_symbol_count );
 }
 
 void get_ast( JobsBuilder &jb, UnitCtx &parent_ctx ) {
@@ -503,8 +725,31 @@ void parse_ast( JobsBuilder &jb, UnitCtx &parent_ctx ) {
         load_base_types( *c_ctx, w_ctx, w_ctx.unit_ctx()->prelude_conf );
         load_syntax_rules( w_ctx, *c_ctx );
 
-        // parse global scope
-        *c_ctx->ast = parse_scope( input, w_ctx, *c_ctx, TT::eof, nullptr );
+        // parse global scope. Unchanged pretokenized files are loaded from the AST cache
+        auto &g_ctx = *w_ctx.global_ctx();
+        auto cache_dir = g_ctx.get_pref<StringSV>( PrefType::ast_cache_dir );
+        auto buffered_input = std::dynamic_pointer_cast<BufferedInput>( input );
+        bool use_cache = !cache_dir.empty() && buffered_input;
+        u64 cache_key = 0;
+        if ( use_cache ) {
+            cache_key = get_ast_cache_key( *buffered_input->get_source(), w_ctx.unit_ctx()->prelude_conf );
+        }
+        if ( !use_cache || !load_cached_ast( cache_dir, cache_key, input->get_filename(), *c_ctx->ast ) ) {
+            auto message_count = [&g_ctx]() {
+                return g_ctx.error_count.load() + g_ctx.warning_count.load() + g_ctx.notification_count.load();
+            };
+            size_t old_message_count = message_count();
+            {
+                PassTimer timer( w_ctx, "parse_scope" );
+                *c_ctx->ast = parse_global_scope( input, w_ctx, c_ctx );
+                if ( timer.enabled() )
+                    timer.add_nodes( count_ast_nodes( *c_ctx->ast ) );
+            }
+
+            // Messages are not stored, so only ASTs without messages are cached
+            if ( use_cache && message_count() == old_message_count )
+                store_cached_ast( cache_dir, cache_key, *c_ctx->ast, *input->get_filename() );
+        }
         w_ctx.do_query( parse_symbols, c_ctx );
 
         // DEBUG print AST
@@ -521,7 +766,7 @@ void parse_ast( JobsBuilder &jb, UnitCtx &parent_ctx ) {
             log( " " + to_string( i ) + " add_size " + to_string( type.additional_mem_size ) + " - sym " +
                  get_full_symbol_name( *c_ctx, w_ctx, type.symbol ) );
             for ( const auto &m : c_ctx->type_table[i].members ) {
-                log( "  member " + m.identifier.name );
+                log( "  member " + m.identifier.name.str() );
             }
         }
         log( "----------------" );
@@ -14,9 +14,10 @@
 #include "libpushc/stdafx.h"
 #include "libpushc/AstParser.h"
 #include "libpushc/Expression.h"
+#include "libpushc/Prelude.h"
 
 // Translate a syntax into a syntax rule
-void parse_rule( SyntaxRule &sr, LabelMap &lm, Syntax &syntax_list ) {
+void parse_rule( SyntaxRule &sr, LabelMap &lm, const Syntax &syntax_list ) {
     sr.expr_list.clear();
     lm.clear();
 
@@ -52,16 +53,17 @@ void parse_rule( SyntaxRule &sr, LabelMap &lm, Syntax &syntax_list ) {
         } else {
             // Keyword or operator
             auto node = AstNode{ ExprType::token };
-            node.token = Token( Token::Type::op, expr.first, nullptr, 0, 0, 0, "", TokenLevel::normal );
+            node.token = InternedString( expr.first );
+            node.token_type = Token::Type::op;
             sr.expr_list.push_back( node );
         }
         ctr++;
     }
 }
 
-void load_syntax_rules( Worker &w_ctx, CrateCtx &c_ctx ) {
-    auto pc = w_ctx.unit_ctx()->prelude_conf;
-
+// Translates all syntaxes into sorted syntax rules
+sptr<SyntaxTable> build_syntax_table( const std::map<SyntaxType, std::vector<Operator>> &syntaxes ) {
+    auto table = make_shared<SyntaxTable>();
     SyntaxRule new_rule;
     LabelMap lm;
 
@@ -127,7 +129,7 @@ void load_syntax_rules( Worker &w_ctx, CrateCtx &c_ctx ) {
 
     };
 
-    auto syntax_handler = [&]( Operator &op, SyntaxType type ) {
+    auto syntax_handler = [&]( const Operator &op, SyntaxType type ) {
         parse_rule( new_rule, lm, op.syntax );
         new_rule.precedence = op.precedence;
         new_rule.ltr = op.ltr;
@@ -136,52 +138,93 @@ void load_syntax_rules( Worker &w_ctx, CrateCtx &c_ctx ) {
         new_rule.prec_bias = op.prec_bias;
 
         auto ast_type = ast_type_map.at( type );
+        auto precedence = new_rule.precedence;
         new_rule.create = [=]( std::vector<AstNode> &list, Worker &w_ctx ) {
             auto node = AstNode{ ast_type };
             node.generate_new_props();
             node.pos_info = merge_pos_infos( list.front().pos_info, list.back().pos_info );
-            node.precedence = new_rule.precedence;
-            node.original_list = list;
+            node.precedence = precedence;
+
+            // Where each matched expression is stored in the new node
+            using Source = OriginalListEntry::Source;
+            std::vector<OriginalListEntry> original( list.size(), OriginalListEntry{ Source::stored, 0 } );
+            size_t merged_idx = list.size(); // comma list which was merged into this one
+            size_t merged_children_offset = 0;
+            auto add_child = [&]( size_t idx ) {
+                original[idx] = OriginalListEntry{ Source::child, static_cast<u32>( node.children.size() ) };
+                node.children.push_back( std::move( list[idx] ) );
+            };
+
             for ( auto &mapping : lm ) {
                 if ( mapping.first == "child" || mapping.first == "child0" || mapping.first == "child1" ) {
-                    node.children.push_back( list[mapping.second] );
+                    add_child( mapping.second );
                 } else if ( mapping.first == "head" ) {
                     if ( ast_type == ExprType::func || ast_type == ExprType::compiler_annotation ) {
-                        auto head = list[mapping.second];
+                        auto &head = list[mapping.second];
                         node.named.insert( head.named.begin(), head.named.end() );
                     } else {
-                        node.children.push_back( list[mapping.second] ); // handle as normal child
+                        add_child( mapping.second ); // handle as normal child
                     }
                 } else if ( mapping.first == "op" ) {
                     node.token = list[mapping.second].token;
+                    node.token_type = list[mapping.second].token_type;
                 } else if ( mapping.first == "op0" ) {
-                    node.token = list[mapping.second].token;
-                    node.token.content = list[mapping.second].token.content + list[lm.at( "op1" )].token.content;
+                    node.token = InternedString( list[mapping.second].token.str() + list[lm.at( "op1" )].token.str() );
+                    node.token_type = list[mapping.second].token_type;
                 } else if ( !mapping.first.empty() && mapping.first != "op1" ) {
                     // Special handling
                     if ( ast_type == ExprType::comma_list ) {
                         // Merge multiple comma lists
                         if ( list[mapping.second].type == ExprType::comma_list ) {
-                            node.children.insert( node.children.end(), list[mapping.second].children.begin(),
-                                                  list[mapping.second].children.end() );
-                            // Fix original_list
-                            // The erasing should work, because only one element will ever be removed from the list
-                            node.original_list.erase( node.original_list.begin() + mapping.second );
-                            node.original_list.insert( node.original_list.end(),
-                                                       list[mapping.second].original_list.begin(),
-                                                       list[mapping.second].original_list.end() );
+                            merged_idx = mapping.second;
+                            merged_children_offset = node.children.size();
+                            node.children.insert( node.children.end(),
+                                                  std::make_move_iterator( list[mapping.second].children.begin() ),
+                                                  std::make_move_iterator( list[mapping.second].children.end() ) );
                         } else {
                             // Ignore the label of the entries in the prelude
-                            node.children.push_back( list[mapping.second] );
+                            add_child( mapping.second );
                         }
                     } else {
                         // Normal named elements
-                        node.named[ast_child_map.at( mapping.first )] = list[mapping.second];
+                        auto child = ast_child_map.at( mapping.first );
+                        original[mapping.second] = OriginalListEntry{ Source::named, static_cast<u32>( child ) };
+                        node.named[child] = std::move( list[mapping.second] );
                     }
                 }
             }
 
-            node.symbol_name = op.fn;
+            // Separable expressions keep their original list. Children and named expressions are only referenced
+            if ( node.has_prop( ExprProperty::separable ) ) {
+                auto &payload = node.mutable_payload();
+                for ( size_t i = 0; i < list.size(); i++ ) {
+                    if ( i == merged_idx )
+                        continue;
+                    if ( original[i].source == Source::stored ) {
+                        original[i].index = payload.original_stored.size();
+                        payload.original_stored.push_back( std::move( list[i] ) );
+                    }
+                    payload.original_list.push_back( original[i] );
+                }
+                if ( merged_idx < list.size() && list[merged_idx].get_payload() ) {
+                    // The original list of a merged comma list is appended
+                    auto &merged = list[merged_idx];
+                    auto &merged_list = merged.get_payload()->original_list;
+                    for ( size_t i = 0; i < merged_list.size(); i++ ) {
+                        auto entry = merged_list[i];
+                        if ( entry.source == Source::child ) {
+                            entry.index += merged_children_offset;
+                        } else {
+                            entry.source = Source::stored;
+                            entry.index = payload.original_stored.size();
+                            payload.original_stored.push_back( std::move( merged.original_at( i ) ) );
+                        }
+                        payload.original_list.push_back( entry );
+                    }
+                }
+            }
+
+            node.symbol_name = InternedString( op.fn );
             node.range_type = op.range;
             if ( ast_type == ExprType::pre_loop || ast_type == ExprType::post_loop ) {
                 if ( type == SyntaxType::pre_cond_loop_abort || type == SyntaxType::post_cond_loop_abort ) {
@@ -203,15 +246,32 @@ void load_syntax_rules( Worker &w_ctx, CrateCtx &c_ctx ) {
         };
     };
 
-    for ( auto &syntax : pc.syntaxes ) {
+    for ( auto &syntax : syntaxes ) {
         for ( auto &op : syntax.second ) {
             syntax_handler( op, syntax.first );
-            c_ctx.rules.push_back( new_rule );
+            table->rules.push_back( new_rule );
         }
     }
 
     // Sort rules after precedence
-    std::stable_sort( c_ctx.rules.begin(), c_ctx.rules.end(), []( auto &l, auto &r ) {
+    std::stable_sort( table->rules.begin(), table->rules.end(), []( auto &l, auto &r ) {
         return l.prec_bias > r.prec_bias || ( l.prec_bias == r.prec_bias && l.precedence > r.precedence );
     } );
+    table->index.build( table->rules );
+    return table;
+}
+
+void compile_syntax_table( const std::map<SyntaxType, std::vector<Operator>> &syntaxes, JobsBuilder &jb,
+                           UnitCtx &parent_ctx ) {
+    jb.add_job<sptr<const SyntaxTable>>( [syntaxes]( Worker &w_ctx ) {
+        return sptr<const SyntaxTable>( build_syntax_table( syntaxes ) );
+    } );
+}
+
+void load_syntax_rules( Worker &w_ctx, CrateCtx &c_ctx ) {
+    PassTimer timer( w_ctx, "load_syntax_rules" );
+    c_ctx.syntax_table = w_ctx.do_query( compile_syntax_table, w_ctx.unit_ctx()->prelude_conf.syntaxes )
+                             ->jobs.back()
+                             ->to<sptr<const SyntaxTable>>();
+    timer.add_nodes( c_ctx.syntax_table->rules.size() );
 }
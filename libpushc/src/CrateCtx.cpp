@@ -15,18 +15,84 @@
 #include "libpushc/CrateCtx.h"
 #include "libpushc/Expression.h"
 
-bool SyntaxRule::matches_reversed( std::vector<AstNode> &rev_list ) {
+bool SyntaxRule::matches_reversed( const std::vector<AstNode *> &rev_list ) const {
     if ( rev_list.size() < expr_list.size() )
         return false;
 
     for ( int i = 0; i < expr_list.size(); i++ ) {
-        if ( !rev_list[i].matches( expr_list[expr_list.size() - i - 1] ) ) {
+        if ( !rev_list[i]->matches( expr_list[expr_list.size() - i - 1] ) ) {
             return false;
         }
     }
     return true;
 }
 
+void SyntaxRuleIndex::build( const std::vector<SyntaxRule> &rules ) {
+    by_token.clear();
+    by_type.clear();
+    by_props.clear();
+    always.clear();
+    rule_count = rules.size();
+
+    for ( size_t i = 0; i < rules.size(); i++ ) {
+        if ( rules[i].expr_list.empty() ) {
+            always.push_back( i );
+            continue;
+        }
+        auto &last = rules[i].expr_list.back();
+        if ( last.type == ExprType::token )
+            by_token[last.token].push_back( i );
+        else if ( last.type != ExprType::none )
+            by_type[last.type].push_back( i );
+        else
+            by_props.push_back( i );
+    }
+}
+
+void SyntaxRuleIndex::add_candidates_of( const std::vector<SyntaxRule> &rules, const AstNode &expr,
+                                         std::vector<size_t> &candidates ) const {
+    if ( expr.type == ExprType::token ) {
+        auto itr = by_token.find( expr.token );
+        if ( itr != by_token.end() )
+            candidates.insert( candidates.end(), itr->second.begin(), itr->second.end() );
+    } else {
+        auto itr = by_type.find( expr.type );
+        if ( itr != by_type.end() ) {
+            candidates.insert( candidates.end(), itr->second.begin(), itr->second.end() );
+        }
+    }
+    for ( auto i : by_props ) {
+        if ( expr.matches( rules[i].expr_list.back() ) )
+            candidates.push_back( i );
+    }
+}
+
+void SyntaxRuleIndex::collect_candidates( const std::vector<SyntaxRule> &rules, const AstNode *newest_expr,
+                                          bool allow_split, std::vector<size_t> &candidates ) const {
+    candidates = always;
+
+    // The newest expression or (if it is split up) the last of its original sub-expressions will be matched
+    const AstNode *expr = newest_expr;
+    if ( expr ) {
+        add_candidates_of( rules, *expr, candidates );
+        while ( allow_split && expr->has_prop( ExprProperty::separable ) ) {
+            if ( !expr->get_payload() || expr->get_payload()->original_list.empty() ) {
+                // Can't predict the newest expression, so check every rule
+                candidates.resize( rule_count );
+                for ( size_t i = 0; i < rule_count; i++ )
+                    candidates[i] = i;
+                return;
+            }
+            expr = &expr->original_at( expr->get_payload()->original_list.size() - 1 );
+            add_candidates_of( rules, *expr, candidates );
+        }
+    }
+
+    // Restore the order of the rules
+    std::sort( candidates.begin(), candidates.end() );
+    candidates.erase( std::unique( candidates.begin(), candidates.end() ), candidates.end() );
+}
+
 CrateCtx::CrateCtx() {
     ast = make_shared<AstNode>();
     symbol_graph.resize( 2 );
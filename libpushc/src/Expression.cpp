@@ -15,6 +15,7 @@
 #include "libpushc/Expression.h"
 #include "libpushc/SymbolUtil.h"
 #include "libpushc/MirTranslation.h"
+#include "libpushc/VisitorPasses.h"
 
 // Defined here, because libpush does not define the Expr symbol
 MessageInfo::MessageInfo( const AstNode &expr, u32 message_idx, FmtStr::Color color )
@@ -23,13 +24,15 @@ MessageInfo::MessageInfo( const AstNode &expr, u32 message_idx, FmtStr::Color co
 
 
 // Used with alias statements. Returns the list of the subsitutions rules from the alias expr
-std::vector<SymbolSubstitution> get_substitutions( CrateCtx &c_ctx, Worker &w_ctx, AstNode &expr ) {
+std::vector<SymbolSubstitution> get_substitutions( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx,
+                                                   AstNode &expr ) {
+    std::lock_guard<std::mutex> lock( c_ctx.symbol_graph_mtx ); // may instantiate templates
     std::vector<SymbolSubstitution> result;
     if ( expr.children[0].has_prop( ExprProperty::assignment ) ) {
-        result.push_back( { expr.children[0].named[AstChild::left_expr].get_symbol_chain( c_ctx, w_ctx ),
-                            expr.children[0].named[AstChild::right_expr].get_symbol_chain( c_ctx, w_ctx ) } );
+        result.push_back( { expr.children[0].named[AstChild::left_expr].get_symbol_chain( c_ctx, t_ctx, w_ctx ),
+                            expr.children[0].named[AstChild::right_expr].get_symbol_chain( c_ctx, t_ctx, w_ctx ) } );
     } else {
-        auto chain = expr.children[0].get_symbol_chain( c_ctx, w_ctx );
+        auto chain = expr.children[0].get_symbol_chain( c_ctx, t_ctx, w_ctx );
         result.push_back( { make_shared<std::vector<SymbolIdentifier>>( 1, chain->back() ), chain } );
     }
     return result;
@@ -249,65 +252,66 @@ void AstNode::generate_new_props() {
     }
 }
 
-void AstNode::split_prepend_recursively( std::vector<AstNode> &rev_list, std::vector<AstNode> &stst_set, u32 prec,
+AstNode &AstNode::original_at( size_t idx ) {
+    auto &entry = get_payload()->original_list[idx];
+    if ( entry.source == OriginalListEntry::Source::child ) {
+        return children[entry.index];
+    } else if ( entry.source == OriginalListEntry::Source::named ) {
+        auto itr = named.find( static_cast<AstChild>( entry.index ) );
+        if ( itr == named.end() )
+            LOG_ERR( "Original list refers to a missing named child" );
+        return named[static_cast<AstChild>( entry.index )];
+    } else {
+        return get_payload()->original_stored[entry.index];
+    }
+}
+
+void AstNode::split_prepend_recursively( std::vector<AstNode *> &rev_list, std::vector<AstNode *> &stst_set, u32 prec,
                                          bool ltr, u8 rule_length ) {
-    stst_set.insert( stst_set.end(), static_statements.begin(), static_statements.end() );
-    for ( auto expr_itr = original_list.rbegin(); expr_itr != original_list.rend(); expr_itr++ ) {
-        auto s_expr = *expr_itr;
+    // Explicit stack of separated expressions and the count of their original list entries which are left
+    std::vector<std::pair<AstNode *, size_t>> stack = { { this, 0 } };
+    if ( auto *payload = get_payload() ) {
+        stack.back().second = payload->original_list.size();
+        for ( auto &ss : payload->static_statements )
+            stst_set.push_back( &ss );
+    }
+    while ( !stack.empty() ) {
+        auto &top = stack.back();
+        if ( top.second == 0 ) {
+            stack.pop_back();
+            continue;
+        }
+
+        auto &s_expr = top.first->original_at( --top.second );
         if ( rev_list.size() < rule_length && s_expr.has_prop( ExprProperty::separable ) &&
              ( prec < s_expr.precedence || ( !ltr && prec == s_expr.precedence ) ) ) {
-            s_expr.split_prepend_recursively( rev_list, stst_set, prec, ltr, rule_length );
+            if ( auto *payload = s_expr.get_payload() ) {
+                for ( auto &ss : payload->static_statements )
+                    stst_set.push_back( &ss );
+                stack.emplace_back( &s_expr, payload->original_list.size() ); // continue with s_expr
+            }
         } else {
-            rev_list.push_back( *expr_itr );
+            rev_list.push_back( &s_expr );
         }
     }
 }
 
 bool AstNode::visit( CrateCtx &c_ctx, Worker &w_ctx, VisitorPassType vpt, AstNode &parent, bool expect_operand ) {
-    // Visit this
-    if ( vpt == VisitorPassType::BASIC_SEMANTIC_CHECK ) {
-        if ( !basic_semantic_check( c_ctx, w_ctx ) )
-            return false;
-    } else if ( vpt == VisitorPassType::FIRST_TRANSFORMATION ) {
-        if ( !first_transformation( c_ctx, w_ctx, parent, expect_operand ) )
-            return false;
-    } else if ( vpt == VisitorPassType::SYMBOL_DISCOVERY ) {
-        if ( !symbol_discovery( c_ctx, w_ctx ) )
-            return false;
-    }
-
-    bool result = true;
-    for ( auto &ss : static_statements ) {
-        if ( !ss.visit( c_ctx, w_ctx, vpt, *this, expect_operand ) )
-            result = false;
-    }
-    for ( auto &a : annotations ) {
-        if ( !a.visit( c_ctx, w_ctx, vpt, *this, expect_operand ) )
-            result = false;
-    }
-
-    // Visit sub-elements
-    for ( auto &node : named ) {
-        if ( !node.second.visit( c_ctx, w_ctx, vpt, *this, expect_operand ) )
-            result = false;
-    }
-    for ( auto &node : children ) {
-        if ( !node.visit( c_ctx, w_ctx, vpt, *this, expect_operand ) )
-            result = false;
-    }
-
-    // Post-visit
-    if ( result ) {
-        if ( vpt == VisitorPassType::SYMBOL_DISCOVERY ) {
-            if ( !post_symbol_discovery( c_ctx, w_ctx ) )
-                return false;
-        }
+    TraversalCtx t_ctx;
+    switch ( vpt ) {
+    case VisitorPassType::BASIC_SEMANTIC_CHECK:
+        return visit_fused<BasicSemanticCheckPass>( *this, parent, expect_operand, c_ctx, t_ctx, w_ctx );
+    case VisitorPassType::FIRST_TRANSFORMATION:
+        return visit_fused<FirstTransformationPass>( *this, parent, expect_operand, c_ctx, t_ctx, w_ctx );
+    case VisitorPassType::SYMBOL_DISCOVERY:
+        return visit_fused<SymbolDiscoveryPass>( *this, parent, expect_operand, c_ctx, t_ctx, w_ctx );
+    default:
+        LOG_ERR( "Unknown visitor pass type" );
+        return false;
     }
-
-    return result;
 }
 
-sptr<std::vector<SymbolIdentifier>> AstNode::get_symbol_chain( CrateCtx &c_ctx, Worker &w_ctx ) {
+sptr<std::vector<SymbolIdentifier>> AstNode::get_symbol_chain( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx ) {
     if ( !has_prop( ExprProperty::symbol_like ) ) {
         LOG_ERR( "Tried to get symbol chain from non-symbol" );
         return make_shared<std::vector<SymbolIdentifier>>();
@@ -316,8 +320,8 @@ sptr<std::vector<SymbolIdentifier>> AstNode::get_symbol_chain( CrateCtx &c_ctx,
     if ( type == ExprType::atomic_symbol ) {
         return make_shared<std::vector<SymbolIdentifier>>( 1, SymbolIdentifier{ symbol_name } );
     } else if ( type == ExprType::scope_access ) {
-        auto base = named[AstChild::base].get_symbol_chain( c_ctx, w_ctx );
-        auto member = named[AstChild::member].get_symbol_chain( c_ctx, w_ctx );
+        auto base = named[AstChild::base].get_symbol_chain( c_ctx, t_ctx, w_ctx );
+        auto member = named[AstChild::member].get_symbol_chain( c_ctx, t_ctx, w_ctx );
         base->insert( base->end(), member->begin(), member->end() );
         return base;
     } else if ( type == ExprType::template_postfix ) {
@@ -326,7 +330,7 @@ sptr<std::vector<SymbolIdentifier>> AstNode::get_symbol_chain( CrateCtx &c_ctx,
             TypeId type = c_ctx.type_type;
             if ( c.type == ExprType::typed_op ) {
                 auto types = find_local_symbol_by_identifier_chain(
-                    c_ctx, w_ctx, c.named[AstChild::right_expr].get_symbol_chain( c_ctx, w_ctx ) );
+                    c_ctx, t_ctx, w_ctx, c.named[AstChild::right_expr].get_symbol_chain( c_ctx, t_ctx, w_ctx ) );
                 if ( !expect_exactly_one_symbol( c_ctx, w_ctx, types, c ) )
                     return nullptr;
                 type = types.front();
@@ -335,15 +339,16 @@ sptr<std::vector<SymbolIdentifier>> AstNode::get_symbol_chain( CrateCtx &c_ctx,
             template_values.push_back( std::make_pair( type, ConstValue() ) ); // TODO insert default values here
         }
 
-        auto chain = named[AstChild::symbol].get_symbol_chain( c_ctx, w_ctx );
+        auto chain = named[AstChild::symbol].get_symbol_chain( c_ctx, t_ctx, w_ctx );
         chain->back().template_values = template_values;
         return chain;
     } else if ( type == ExprType::unit ) {
-        return make_shared<std::vector<SymbolIdentifier>>( 1, SymbolIdentifier{ "()" } );
+        return make_shared<std::vector<SymbolIdentifier>>( 1, SymbolIdentifier{ InternedString( "()" ) } );
     } else if ( type == ExprType::tuple ) {
         std::vector<std::pair<TypeId, ConstValue>> template_values;
         for ( auto &c : children ) {
-            auto types = find_local_symbol_by_identifier_chain( c_ctx, w_ctx, c.get_symbol_chain( c_ctx, w_ctx ) );
+            auto types = find_local_symbol_by_identifier_chain( c_ctx, t_ctx, w_ctx,
+                                                                c.get_symbol_chain( c_ctx, t_ctx, w_ctx ) );
             if ( !expect_exactly_one_symbol( c_ctx, w_ctx, types, c ) )
                 return nullptr;
             template_values.push_back(
@@ -362,7 +367,7 @@ sptr<std::vector<SymbolIdentifier>> AstNode::get_symbol_chain( CrateCtx &c_ctx,
 bool AstNode::basic_semantic_check( CrateCtx &c_ctx, Worker &w_ctx ) {
     // Checks based on properties
     if ( has_prop( ExprProperty::temporary ) ) {
-        w_ctx.print_msg<MessageType::err_orphan_token>( MessageInfo( token, 0, FmtStr::Color::Red ) );
+        w_ctx.print_msg<MessageType::err_orphan_token>( MessageInfo( pos_info, 0, FmtStr::Color::Red ) );
         return false;
     }
 
@@ -605,7 +610,8 @@ bool AstNode::basic_semantic_check( CrateCtx &c_ctx, Worker &w_ctx ) {
     return true;
 }
 
-bool AstNode::first_transformation( CrateCtx &c_ctx, Worker &w_ctx, AstNode &parent, bool &expect_operand ) {
+bool AstNode::first_transformation( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, AstNode &parent,
+                                    bool &expect_operand ) {
     // Transformations based on properties
     if ( has_prop( ExprProperty::braces ) ) {
         std::vector<AstNode> annotation_list;
@@ -617,7 +623,7 @@ bool AstNode::first_transformation( CrateCtx &c_ctx, Worker &w_ctx, AstNode &par
                 i--;
                 continue;
             } else if ( !annotation_list.empty() ) {
-                children[i].annotations = std::move( annotation_list );
+                children[i].mutable_payload().annotations = std::move( annotation_list );
                 annotation_list.clear();
             }
 
@@ -631,7 +637,8 @@ bool AstNode::first_transformation( CrateCtx &c_ctx, Worker &w_ctx, AstNode &par
                     continue;
                 } else if ( expr.type == ExprType::alias_bind ) {
                     // Resolve alias statements
-                    auto subs = get_substitutions( c_ctx, w_ctx, expr );
+                    auto subs = get_substitutions( c_ctx, t_ctx, w_ctx, expr );
+                    auto &substitutions = mutable_payload().substitutions;
                     substitutions.insert( substitutions.end(), subs.begin(), subs.end() );
                     children.erase( children.begin() + i );
                     i--;
@@ -653,18 +660,18 @@ bool AstNode::first_transformation( CrateCtx &c_ctx, Worker &w_ctx, AstNode &par
             type = ExprType::decl_scope;
             props.clear();
             generate_new_props();
-            return first_transformation( c_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
+            return first_transformation( c_ctx, t_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
         }
 
         auto tmp = children.front();
         *this = tmp;
-        return first_transformation( c_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
+        return first_transformation( c_ctx, t_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
     } else if ( type == ExprType::block ) {
         if ( parent.has_prop( ExprProperty::decl_parent ) ) {
             type = ExprType::decl_scope;
             props.clear();
             generate_new_props();
-            return first_transformation( c_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
+            return first_transformation( c_ctx, t_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
         } else {
             // Insert implicit return type
             if ( children.empty() || children.back().type == ExprType::single_completed ) {
@@ -676,27 +683,27 @@ bool AstNode::first_transformation( CrateCtx &c_ctx, Worker &w_ctx, AstNode &par
             type = ExprType::imp_scope;
             props.clear();
             generate_new_props();
-            return first_transformation( c_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
+            return first_transformation( c_ctx, t_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
         }
     } else if ( type == ExprType::set ) {
         if ( parent.has_prop( ExprProperty::decl_parent ) ) {
             type = ExprType::decl_scope;
             props.clear();
             generate_new_props();
-            return first_transformation( c_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
+            return first_transformation( c_ctx, t_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
         }
     } else if ( type == ExprType::func_head ) {
         if ( !parent.has_prop( ExprProperty::decl_parent ) ) {
             type = ExprType::func_call;
             props.clear();
             generate_new_props();
-            return first_transformation( c_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
+            return first_transformation( c_ctx, t_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
         } else {
             type = ExprType::func_decl;
             props.clear();
             generate_new_props();
             return basic_semantic_check( c_ctx, w_ctx ) && // repeat the parameter check
-                   first_transformation( c_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
+                   first_transformation( c_ctx, t_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
         }
     } else if ( type == ExprType::func || type == ExprType::if_bind || type == ExprType::if_cond ||
                 type == ExprType::if_else || type == ExprType::pre_loop || type == ExprType::post_loop ||
@@ -708,7 +715,7 @@ bool AstNode::first_transformation( CrateCtx &c_ctx, Worker &w_ctx, AstNode &par
             type = ( type == ExprType::if_cond ? ExprType::if_bind : ExprType::if_else_bind );
             auto tmp = named[AstChild::cond].children.front();
             named[AstChild::cond] = tmp;
-            return first_transformation( c_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
+            return first_transformation( c_ctx, t_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
         }
 
         if ( type == ExprType::func && expect_operand && named.find( AstChild::parameters ) == named.end() &&
@@ -717,7 +724,7 @@ bool AstNode::first_transformation( CrateCtx &c_ctx, Worker &w_ctx, AstNode &par
             type = ExprType::struct_initializer;
             props.clear();
             generate_new_props();
-            return first_transformation( c_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
+            return first_transformation( c_ctx, t_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
         } else {
             if ( children.front().type == ExprType::set ) {
                 w_ctx.print_msg<MessageType::err_comma_list_not_allowed>(
@@ -773,16 +780,16 @@ bool AstNode::first_transformation( CrateCtx &c_ctx, Worker &w_ctx, AstNode &par
         named[AstChild::index] = tmp;
     } else if ( type == ExprType::reference ) {
         auto tmp = named[AstChild::symbol_like];
-        if ( props.find( ExprProperty::mut ) != props.end() )
+        if ( has_prop( ExprProperty::mut ) )
             tmp.props.insert( ExprProperty::mut );
         tmp.props.insert( ExprProperty::ref );
         *this = tmp;
-        return first_transformation( c_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
+        return first_transformation( c_ctx, t_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
     } else if ( type == ExprType::mutable_attr ) {
         auto tmp = named[AstChild::symbol_like];
         *this = tmp;
         props.insert( ExprProperty::mut );
-        return first_transformation( c_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
+        return first_transformation( c_ctx, t_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
     } else if ( type == ExprType::public_attr ) {
         if ( parent.type != ExprType::decl_scope ) {
             // public symbols are only allowed in decl scopes
@@ -794,7 +801,7 @@ bool AstNode::first_transformation( CrateCtx &c_ctx, Worker &w_ctx, AstNode &par
         auto tmp = children.front();
         *this = tmp;
         props.insert( ExprProperty::pub );
-        return first_transformation( c_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
+        return first_transformation( c_ctx, t_ctx, w_ctx, parent, expect_operand ); // repeat for new entry
     } else if ( type == ExprType::template_postfix ) {
         if ( children.front().type == ExprType::comma_list ) {
             children.insert( children.end(), children.front().children.begin(), children.front().children.end() );
@@ -812,22 +819,25 @@ bool AstNode::first_transformation( CrateCtx &c_ctx, Worker &w_ctx, AstNode &par
     return true;
 }
 
-bool AstNode::symbol_discovery( CrateCtx &c_ctx, Worker &w_ctx ) {
-    c_ctx.current_substitutions.push_back( substitutions );
+bool AstNode::symbol_discovery( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx ) {
+    t_ctx.current_substitutions.emplace_back();
+    if ( auto *payload = get_payload() )
+        t_ctx.current_substitutions.back() = payload->substitutions;
 
     if ( has_prop( ExprProperty::anonymous_scope ) ) {
-        SymbolId new_id = create_new_local_symbol( c_ctx, w_ctx, SymbolIdentifier{} );
+        SymbolId new_id = create_new_local_symbol( c_ctx, t_ctx, w_ctx, SymbolIdentifier{} );
         scope_symbol = new_id;
-        switch_scope_to_symbol( c_ctx, w_ctx, new_id );
+        switch_scope_to_symbol( c_ctx, t_ctx, w_ctx, new_id );
         c_ctx.symbol_graph[new_id].original_expr.push_back( this );
     } else if ( has_prop( ExprProperty::named_scope ) ) {
         auto &symbol = named[type == ExprType::implementation ? AstChild::struct_symbol : AstChild::symbol];
         SymbolId new_id =
-            create_new_local_symbol_from_name_chain( c_ctx, w_ctx, symbol.get_symbol_chain( c_ctx, w_ctx ), symbol );
+            create_new_local_symbol_from_name_chain( c_ctx, t_ctx, w_ctx,
+                                                     symbol.get_symbol_chain( c_ctx, t_ctx, w_ctx ), symbol );
         scope_symbol = new_id;
-        symbol.update_left_symbol_id( c_ctx.symbol_graph[c_ctx.current_scope].sub_nodes.back() );
+        symbol.update_left_symbol_id( c_ctx.symbol_graph[t_ctx.current_scope].sub_nodes.back() );
         symbol.update_symbol_id( new_id );
-        switch_scope_to_symbol( c_ctx, w_ctx, new_id );
+        switch_scope_to_symbol( c_ctx, t_ctx, w_ctx, new_id );
         c_ctx.symbol_graph[new_id].original_expr.push_back( this );
         c_ctx.symbol_graph[new_id].pub = symbol.has_prop( ExprProperty::pub );
         if ( type == ExprType::structure ) {
@@ -850,7 +860,7 @@ bool AstNode::symbol_discovery( CrateCtx &c_ctx, Worker &w_ctx ) {
                 }
 
                 // Check if scope is right
-                auto identifier_list = symbol->get_symbol_chain( c_ctx, w_ctx );
+                auto identifier_list = symbol->get_symbol_chain( c_ctx, t_ctx, w_ctx );
                 if ( identifier_list->size() != 1 ) {
                     w_ctx.print_msg<MessageType::err_member_in_invalid_scope>(
                         MessageInfo( *symbol, 0, FmtStr::Color::Red ) );
@@ -895,14 +905,14 @@ bool AstNode::symbol_discovery( CrateCtx &c_ctx, Worker &w_ctx ) {
     return true;
 }
 
-bool AstNode::post_symbol_discovery( CrateCtx &c_ctx, Worker &w_ctx ) {
-    c_ctx.current_substitutions.pop_back();
+bool AstNode::post_symbol_discovery( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx ) {
+    t_ctx.current_substitutions.pop_back();
 
     if ( has_prop( ExprProperty::anonymous_scope ) ) {
-        pop_scope( c_ctx, w_ctx );
+        pop_scope( c_ctx, t_ctx, w_ctx );
     } else if ( has_prop( ExprProperty::named_scope ) ) {
         switch_scope_to_symbol(
-            c_ctx, w_ctx,
+            c_ctx, t_ctx, w_ctx,
             c_ctx
                 .symbol_graph[named[type == ExprType::implementation ? AstChild::struct_symbol : AstChild::symbol]
                                   .get_left_symbol_id()]
@@ -957,17 +967,17 @@ SymbolId AstNode::get_left_symbol_id() {
     }
 }
 
-void AstNode::find_types( CrateCtx &c_ctx, Worker &w_ctx ) {
+void AstNode::find_types( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx ) {
     if ( type == ExprType::structure ) {
         for ( auto &member : children.front().children ) {
             // Search for the type
             if ( member.type == ExprType::typed_op ) {
-                auto type_si = member.named[AstChild::right_expr].get_symbol_chain( c_ctx, w_ctx );
-                auto type_symbols = find_local_symbol_by_identifier_chain( c_ctx, w_ctx, type_si );
+                auto type_si = member.named[AstChild::right_expr].get_symbol_chain( c_ctx, t_ctx, w_ctx );
+                auto type_symbols = find_local_symbol_by_identifier_chain( c_ctx, t_ctx, w_ctx, type_si );
                 if ( !expect_exactly_one_symbol( c_ctx, w_ctx, type_symbols, member ) )
                     return;
 
-                auto symbol_si = member.named[AstChild::left_expr].get_symbol_chain( c_ctx, w_ctx )->front();
+                auto symbol_si = member.named[AstChild::left_expr].get_symbol_chain( c_ctx, t_ctx, w_ctx )->front();
                 auto this_symbol_id = named[AstChild::symbol].get_symbol_id();
                 auto possible_members = find_member_symbol_by_identifier( c_ctx, w_ctx, symbol_si, this_symbol_id );
 
@@ -978,43 +988,43 @@ void AstNode::find_types( CrateCtx &c_ctx, Worker &w_ctx ) {
     }
 }
 
-MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func ) {
+MirVarId AstNode::parse_mir( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, FunctionImplId func ) {
     // Switch scope if needed
-    auto parent_scope_symbol = c_ctx.current_scope;
+    auto parent_scope_symbol = t_ctx.current_scope;
     if ( scope_symbol != 0 )
-        switch_scope_to_symbol( c_ctx, w_ctx, scope_symbol );
+        switch_scope_to_symbol( c_ctx, t_ctx, w_ctx, scope_symbol );
 
     MirVarId ret = 0; // initialize with invalid value
 
     // Create the mir instructions
     switch ( type ) {
     case ExprType::imp_scope: {
-        c_ctx.curr_living_vars.emplace_back();
-        c_ctx.curr_name_mapping.emplace_back();
+        t_ctx.curr_living_vars.emplace_back();
+        t_ctx.curr_name_mapping.emplace_back();
 
         // Handle all expressions
         if ( children.size() > 1 ) {
             for ( auto expr = children.begin(); expr != children.end() - 1; expr++ ) {
-                auto var = expr->parse_mir( c_ctx, w_ctx, func );
+                auto var = expr->parse_mir( c_ctx, t_ctx, w_ctx, func );
                 if ( c_ctx.functions[func].vars[var].type == MirVariable::Type::rvalue ) {
-                    drop_variable( c_ctx, w_ctx, func, *expr, var ); // drop dangling rvalue
+                    drop_variable( c_ctx, t_ctx, w_ctx, func, *expr, var ); // drop dangling rvalue
                 }
             }
         }
         if ( children.empty() ) {
             LOG_ERR( "No return value from block" );
         }
-        ret = children.back().parse_mir( c_ctx, w_ctx, func );
+        ret = children.back().parse_mir( c_ctx, t_ctx, w_ctx, func );
 
         // Drop all created variables
-        for ( auto var_itr = c_ctx.curr_living_vars.back().rbegin(); var_itr != c_ctx.curr_living_vars.back().rend();
+        for ( auto var_itr = t_ctx.curr_living_vars.back().rbegin(); var_itr != t_ctx.curr_living_vars.back().rend();
               var_itr++ ) {
             if ( *var_itr != ret )
-                drop_variable( c_ctx, w_ctx, func, *this, *var_itr );
+                drop_variable( c_ctx, t_ctx, w_ctx, func, *this, *var_itr );
         }
 
-        c_ctx.curr_name_mapping.pop_back();
-        c_ctx.curr_living_vars.pop_back();
+        t_ctx.curr_name_mapping.pop_back();
+        t_ctx.curr_living_vars.pop_back();
         break;
     }
     case ExprType::unit: {
@@ -1022,7 +1032,7 @@ MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
         break;
     }
     case ExprType::numeric_literal: {
-        auto op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::literal, 0, {} );
+        auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::literal, 0, {} );
         c_ctx.functions[func].ops[op_id].data =
             MirLiteral{ false, c_ctx.literal_data.size(), sizeof( literal_number ) };
 
@@ -1038,7 +1048,8 @@ MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
         break;
     }
     case ExprType::string_literal: {
-        auto op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::literal, 0, {} );
+        auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::literal, 0, {} );
+        auto &literal_string = mutable_payload().literal_string;
         c_ctx.functions[func].ops[op_id].data = MirLiteral{ false, c_ctx.literal_data.size(), literal_string.size() };
 
         c_ctx.literal_data.reserve( c_ctx.literal_data.size() + literal_string.size() );
@@ -1051,13 +1062,13 @@ MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
         break;
     }
     case ExprType::atomic_symbol: {
-        auto name_chain = get_symbol_chain( c_ctx, w_ctx );
+        auto name_chain = get_symbol_chain( c_ctx, t_ctx, w_ctx );
         if ( !expect_unscoped_variable( c_ctx, w_ctx, *name_chain, *this ) )
             break;
 
         bool found = false;
         // Search for a local variable
-        for ( auto itr = c_ctx.curr_name_mapping.rbegin(); itr != c_ctx.curr_name_mapping.rend(); itr++ ) {
+        for ( auto itr = t_ctx.curr_name_mapping.rbegin(); itr != t_ctx.curr_name_mapping.rend(); itr++ ) {
             if ( auto var_itr = itr->find( name_chain->front().name ); var_itr != itr->end() ) {
                 ret = var_itr->second.back();
                 found = true;
@@ -1067,20 +1078,20 @@ MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
 
         if ( !found ) {
             // Search for a symbol
-            auto symbols = find_local_symbol_by_identifier_chain( c_ctx, w_ctx, name_chain );
+            auto symbols = find_local_symbol_by_identifier_chain( c_ctx, t_ctx, w_ctx, name_chain );
 
             // TODO allow multiple symbols (e. g. for function overloading)
 
             if ( !symbols.empty() ) {
                 if ( expect_exactly_one_symbol( c_ctx, w_ctx, symbols, *this ) ) {
-                    ret = create_variable( c_ctx, w_ctx, func, this );
+                    ret = create_variable( c_ctx, t_ctx, w_ctx, func, this );
                     auto &result_var = c_ctx.functions[func].vars[ret];
                     result_var.type = MirVariable::Type::symbol;
                     result_var.value_type = c_ctx.symbol_graph[symbols.front()].value;
                     found = true;
 
                     // Create cosmetic operation
-                    auto op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::symbol, ret, {} );
+                    auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::symbol, ret, {} );
                     c_ctx.functions[func].ops[op_id].symbol = symbols.front();
                 }
             }
@@ -1090,7 +1101,7 @@ MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
             // Frist check if the symbol was just dropped earlier
             for ( auto itr = c_ctx.functions[func].drop_list.rbegin(); itr != c_ctx.functions[func].drop_list.rend();
                   itr++ ) {
-                if ( itr->first == name_chain->front().name ) {
+                if ( itr->first == name_chain->front().name.str() ) {
                     w_ctx.print_msg<MessageType::err_var_not_living>( MessageInfo( *this, 0, FmtStr::Color::Red ),
                                                                       { MessageInfo( *itr->second, 1 ) } );
                     found = true;
@@ -1101,17 +1112,18 @@ MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
         if ( !found ) {
             // Symbol actually not found
             w_ctx.print_msg<MessageType::err_symbol_not_found>(
-                MessageInfo( *this, 0, FmtStr::Color::Red ), std::vector<MessageInfo>(), symbol_name, token.content );
+                MessageInfo( *this, 0, FmtStr::Color::Red ), std::vector<MessageInfo>(), symbol_name.str(),
+                token.str() );
         }
         break;
     }
     case ExprType::func_call: {
         // Extract the symbol variable
-        auto callee_var = named[AstChild::symbol].parse_mir( c_ctx, w_ctx, func );
+        auto callee_var = named[AstChild::symbol].parse_mir( c_ctx, t_ctx, w_ctx, func );
         if ( callee_var != 0 ) {
             // Symbol found
             auto callee = c_ctx.type_table[c_ctx.functions[func].vars[callee_var].value_type].symbol;
-            analyse_function_signature( c_ctx, w_ctx, callee );
+            analyse_function_signature( c_ctx, t_ctx, w_ctx, callee );
 
             // TODO select the function based on its signature
 
@@ -1119,10 +1131,10 @@ MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
             if ( c_ctx.functions[func].vars[callee_var].base_ref != 0 )
                 params.push_back( c_ctx.functions[func].vars[callee_var].base_ref ); // member access
             for ( auto &pe : named[AstChild::parameters].children ) {
-                params.push_back( pe.parse_mir( c_ctx, w_ctx, func ) );
+                params.push_back( pe.parse_mir( c_ctx, t_ctx, w_ctx, func ) );
             }
 
-            ret = c_ctx.functions[func].ops[create_call( c_ctx, w_ctx, func, *this, callee, 0, params )].ret;
+            ret = c_ctx.functions[func].ops[create_call( c_ctx, t_ctx, w_ctx, func, *this, callee, 0, params )].ret;
         }
         break;
     }
@@ -1131,14 +1143,15 @@ MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
             c_ctx, w_ctx, split_symbol_chain( symbol_name, w_ctx.unit_ctx()->prelude_conf.scope_access_operator ) );
 
         for ( auto &candidate : calls ) {
-            analyse_function_signature( c_ctx, w_ctx, candidate );
+            analyse_function_signature( c_ctx, t_ctx, w_ctx, candidate );
         }
 
         // TODO select the function based on its signature
 
         if ( calls.empty() ) {
             w_ctx.print_msg<MessageType::err_operator_symbol_not_found>(
-                MessageInfo( *this, 0, FmtStr::Color::Red ), std::vector<MessageInfo>(), symbol_name, token.content );
+                MessageInfo( *this, 0, FmtStr::Color::Red ), std::vector<MessageInfo>(), symbol_name.str(),
+                token.str() );
             break;
         } else if ( calls.size() > 1 ) {
             std::vector<MessageInfo> notes;
@@ -1147,15 +1160,15 @@ MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
                     notes.push_back( MessageInfo( *c_ctx.symbol_graph[c].original_expr.front(), 1 ) );
             }
             w_ctx.print_msg<MessageType::err_operator_symbol_is_ambiguous>( MessageInfo( *this, 0, FmtStr::Color::Red ),
-                                                                            notes, symbol_name, token.content );
+                                                                            notes, symbol_name.str(), token.str() );
             break;
         }
 
 
-        auto left_result = named[AstChild::left_expr].parse_mir( c_ctx, w_ctx, func );
-        auto right_result = named[AstChild::right_expr].parse_mir( c_ctx, w_ctx, func );
+        auto left_result = named[AstChild::left_expr].parse_mir( c_ctx, t_ctx, w_ctx, func );
+        auto right_result = named[AstChild::right_expr].parse_mir( c_ctx, t_ctx, w_ctx, func );
 
-        auto op_id = create_call( c_ctx, w_ctx, func, *this, calls.front(), 0, { left_result, right_result } );
+        auto op_id = create_call( c_ctx, t_ctx, w_ctx, func, *this, calls.front(), 0, { left_result, right_result } );
 
         ret = c_ctx.functions[func].ops[op_id].ret;
         break;
@@ -1164,198 +1177,202 @@ MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
         // Currently this expr requires to contain an assignment
 
         // Expr operation
-        auto var = children.front().named[AstChild::right_expr].parse_mir( c_ctx, w_ctx, func );
-        children.front().named[AstChild::left_expr].bind_vars( c_ctx, w_ctx, func, var, *this, false );
+        auto var = children.front().named[AstChild::right_expr].parse_mir( c_ctx, t_ctx, w_ctx, func );
+        children.front().named[AstChild::left_expr].bind_vars( c_ctx, t_ctx, w_ctx, func, var, *this, false );
 
         break;
     }
     case ExprType::if_bind: {
         // Create jump label var
-        auto label = create_variable( c_ctx, w_ctx, func, this );
+        auto label = create_variable( c_ctx, t_ctx, w_ctx, func, this );
         c_ctx.functions[func].vars[label].type = MirVariable::Type::label;
 
         // Evaluate expr
-        auto var = named[AstChild::cond].named[AstChild::right_expr].parse_mir( c_ctx, w_ctx, func );
+        auto var = named[AstChild::cond].named[AstChild::right_expr].parse_mir( c_ctx, t_ctx, w_ctx, func );
         auto cond =
-            named[AstChild::cond].named[AstChild::left_expr].check_deconstruction( c_ctx, w_ctx, func, var, *this );
+            named[AstChild::cond].named[AstChild::left_expr].check_deconstruction( c_ctx, t_ctx, w_ctx, func, var,
+                                                                                   *this );
 
         // Insert conditional jump
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, label, { cond } );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, label, { cond } );
 
         // Body
-        auto head = named[AstChild::cond].bind_vars( c_ctx, w_ctx, func, var, *this, true );
-        auto body_var = children.front().parse_mir( c_ctx, w_ctx, func );
-        drop_variable( c_ctx, w_ctx, func, *this, body_var );
-        drop_variable( c_ctx, w_ctx, func, *this, head );
+        auto head = named[AstChild::cond].bind_vars( c_ctx, t_ctx, w_ctx, func, var, *this, true );
+        auto body_var = children.front().parse_mir( c_ctx, t_ctx, w_ctx, func );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, body_var );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, head );
 
         // Insert label
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, label, {} );
-        drop_variable( c_ctx, w_ctx, func, *this, cond );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, label, {} );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, cond );
 
         break; // return the unit var
     }
     case ExprType::if_else_bind: {
         // Create jump label var
-        auto label1 = create_variable( c_ctx, w_ctx, func, this );
+        auto label1 = create_variable( c_ctx, t_ctx, w_ctx, func, this );
         c_ctx.functions[func].vars[label1].type = MirVariable::Type::label;
-        auto label2 = create_variable( c_ctx, w_ctx, func, this );
+        auto label2 = create_variable( c_ctx, t_ctx, w_ctx, func, this );
         c_ctx.functions[func].vars[label2].type = MirVariable::Type::label;
 
         // Evaluate expr
-        auto var = named[AstChild::cond].named[AstChild::right_expr].parse_mir( c_ctx, w_ctx, func );
+        auto var = named[AstChild::cond].named[AstChild::right_expr].parse_mir( c_ctx, t_ctx, w_ctx, func );
         auto cond =
-            named[AstChild::cond].named[AstChild::left_expr].check_deconstruction( c_ctx, w_ctx, func, var, *this );
+            named[AstChild::cond].named[AstChild::left_expr].check_deconstruction( c_ctx, t_ctx, w_ctx, func, var,
+                                                                                   *this );
 
         // Insert conditional jump
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, label1, { cond } );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, label1, { cond } );
 
         // Body
-        auto head = named[AstChild::cond].bind_vars( c_ctx, w_ctx, func, var, *this, true );
-        auto body_var = children.front().parse_mir( c_ctx, w_ctx, func );
-        drop_variable( c_ctx, w_ctx, func, *this, body_var );
-        drop_variable( c_ctx, w_ctx, func, *this, head );
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::jmp, label2, {} );
+        auto head = named[AstChild::cond].bind_vars( c_ctx, t_ctx, w_ctx, func, var, *this, true );
+        auto body_var = children.front().parse_mir( c_ctx, t_ctx, w_ctx, func );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, body_var );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, head );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::jmp, label2, {} );
 
         // Else block
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, label1, {} );
-        body_var = children[1].parse_mir( c_ctx, w_ctx, func );
-        drop_variable( c_ctx, w_ctx, func, *this, body_var );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, label1, {} );
+        body_var = children[1].parse_mir( c_ctx, t_ctx, w_ctx, func );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, body_var );
 
         // Insert label
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, label2, {} );
-        drop_variable( c_ctx, w_ctx, func, *this, cond );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, label2, {} );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, cond );
 
         break; // return the unit var
     }
     case ExprType::if_cond: {
         // Create jump label var
-        auto label = create_variable( c_ctx, w_ctx, func, this );
+        auto label = create_variable( c_ctx, t_ctx, w_ctx, func, this );
         c_ctx.functions[func].vars[label].type = MirVariable::Type::label;
 
         // Evaluate expr
-        auto cond = named[AstChild::cond].parse_mir( c_ctx, w_ctx, func );
+        auto cond = named[AstChild::cond].parse_mir( c_ctx, t_ctx, w_ctx, func );
 
         // Insert conditional jump
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, label, { cond } );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, label, { cond } );
 
         // Body
-        auto body_var = children.front().parse_mir( c_ctx, w_ctx, func );
-        drop_variable( c_ctx, w_ctx, func, *this, body_var );
+        auto body_var = children.front().parse_mir( c_ctx, t_ctx, w_ctx, func );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, body_var );
 
         // Insert label
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, label, {} );
-        drop_variable( c_ctx, w_ctx, func, *this, cond );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, label, {} );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, cond );
 
         break; // return the unit var
     }
     case ExprType::if_else: {
         // Create jump label var
-        auto label1 = create_variable( c_ctx, w_ctx, func, this );
+        auto label1 = create_variable( c_ctx, t_ctx, w_ctx, func, this );
         c_ctx.functions[func].vars[label1].type = MirVariable::Type::label;
-        auto label2 = create_variable( c_ctx, w_ctx, func, this );
+        auto label2 = create_variable( c_ctx, t_ctx, w_ctx, func, this );
         c_ctx.functions[func].vars[label2].type = MirVariable::Type::label;
 
         // Evaluate expr
-        auto cond = named[AstChild::cond].parse_mir( c_ctx, w_ctx, func );
+        auto cond = named[AstChild::cond].parse_mir( c_ctx, t_ctx, w_ctx, func );
 
         // Insert conditional jump
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, label1, { cond } );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, label1, { cond } );
 
         // Body
-        auto body_var = children.front().parse_mir( c_ctx, w_ctx, func );
-        drop_variable( c_ctx, w_ctx, func, *this, body_var );
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::jmp, label2, {} );
+        auto body_var = children.front().parse_mir( c_ctx, t_ctx, w_ctx, func );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, body_var );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::jmp, label2, {} );
 
         // Else block
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, label1, {} );
-        body_var = children[1].parse_mir( c_ctx, w_ctx, func );
-        drop_variable( c_ctx, w_ctx, func, *this, body_var );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, label1, {} );
+        body_var = children[1].parse_mir( c_ctx, t_ctx, w_ctx, func );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, body_var );
 
         // Insert label
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, label2, {} );
-        drop_variable( c_ctx, w_ctx, func, *this, cond );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, label2, {} );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, cond );
 
         break; // return the unit var
     }
     case ExprType::pre_loop: {
         // Create jump label
-        auto label1 = create_variable( c_ctx, w_ctx, func, this );
+        auto label1 = create_variable( c_ctx, t_ctx, w_ctx, func, this );
         c_ctx.functions[func].vars[label1].type = MirVariable::Type::label;
-        auto label2 = create_variable( c_ctx, w_ctx, func, this );
+        auto label2 = create_variable( c_ctx, t_ctx, w_ctx, func, this );
         c_ctx.functions[func].vars[label2].type = MirVariable::Type::label;
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, label1, {} );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, label1, {} );
 
         // Evaluate expr
-        auto cond = named[AstChild::cond].parse_mir( c_ctx, w_ctx, func );
+        auto cond = named[AstChild::cond].parse_mir( c_ctx, t_ctx, w_ctx, func );
 
         // Insert conditional jump
         if ( !continue_eval ) {
-            auto op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::inv, 0, { cond } );
-            drop_variable( c_ctx, w_ctx, func, *this, cond );
+            auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::inv, 0, { cond } );
+            drop_variable( c_ctx, t_ctx, w_ctx, func, *this, cond );
             cond = c_ctx.functions[func].ops[op_id].ret;
         }
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, label2, { cond } );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, label2, { cond } );
 
         // Body
-        auto body_var = children.front().parse_mir( c_ctx, w_ctx, func );
-        drop_variable( c_ctx, w_ctx, func, *this, body_var );
+        auto body_var = children.front().parse_mir( c_ctx, t_ctx, w_ctx, func );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, body_var );
 
-        drop_variable( c_ctx, w_ctx, func, *this, cond );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, cond );
 
         // Jump back to condition
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::jmp, label1, {} );
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, label2, {} );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::jmp, label1, {} );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, label2, {} );
 
         break; // return the unit var
     }
     case ExprType::post_loop: {
         // Create jump label
-        auto label = create_variable( c_ctx, w_ctx, func, this );
+        auto label = create_variable( c_ctx, t_ctx, w_ctx, func, this );
         c_ctx.functions[func].vars[label].type = MirVariable::Type::label;
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, label, {} );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, label, {} );
 
         // Body
-        auto body_var = children.front().parse_mir( c_ctx, w_ctx, func );
-        drop_variable( c_ctx, w_ctx, func, *this, body_var );
+        auto body_var = children.front().parse_mir( c_ctx, t_ctx, w_ctx, func );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, body_var );
 
         // Evaluate expr
-        auto cond = named[AstChild::cond].parse_mir( c_ctx, w_ctx, func );
+        auto cond = named[AstChild::cond].parse_mir( c_ctx, t_ctx, w_ctx, func );
 
         // Insert conditional jump
         if ( continue_eval ) {
-            auto op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::inv, 0, { cond } );
-            drop_variable( c_ctx, w_ctx, func, *this, cond );
+            auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::inv, 0, { cond } );
+            drop_variable( c_ctx, t_ctx, w_ctx, func, *this, cond );
             cond = c_ctx.functions[func].ops[op_id].ret;
         }
-        auto op_id = create_operation( c_ctx, w_ctx, func, named[AstChild::cond], MirEntry::Type::bind, 0, { cond } );
-        drop_variable( c_ctx, w_ctx, func, *this, cond );
+        auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, named[AstChild::cond], MirEntry::Type::bind, 0,
+                                       { cond } );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, cond );
         cond = c_ctx.functions[func].ops[op_id].ret;
         c_ctx.functions[func].vars[cond].type =
             MirVariable::Type::not_dropped; // temporary var which must not be dropped
-        create_operation( c_ctx, w_ctx, func, named[AstChild::cond], MirEntry::Type::cond_jmp_z, label, { cond } );
+        create_operation( c_ctx, t_ctx, w_ctx, func, named[AstChild::cond], MirEntry::Type::cond_jmp_z, label,
+                          { cond } );
 
         break; // return the unit var
     }
     case ExprType::inf_loop: {
         // Create jump label
-        auto label = create_variable( c_ctx, w_ctx, func, this );
+        auto label = create_variable( c_ctx, t_ctx, w_ctx, func, this );
         c_ctx.functions[func].vars[label].type = MirVariable::Type::label;
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, label, {} );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, label, {} );
 
         // Body
-        auto body_var = children.front().parse_mir( c_ctx, w_ctx, func );
-        drop_variable( c_ctx, w_ctx, func, *this, body_var );
+        auto body_var = children.front().parse_mir( c_ctx, t_ctx, w_ctx, func );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, body_var );
 
         // Infinit jump back
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::jmp, label, {} );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::jmp, label, {} );
 
         break; // return the unit var
     }
     case ExprType::itr_loop: {
-        auto loop_label = create_variable( c_ctx, w_ctx, func, this );
+        auto loop_label = create_variable( c_ctx, t_ctx, w_ctx, func, this );
         c_ctx.functions[func].vars[loop_label].type = MirVariable::Type::label;
 
-        auto end_label = create_variable( c_ctx, w_ctx, func, this );
+        auto end_label = create_variable( c_ctx, t_ctx, w_ctx, func, this );
         c_ctx.functions[func].vars[end_label].type = MirVariable::Type::label;
 
         MirVarId iterator = 0, right_result = 0;
@@ -1369,15 +1386,15 @@ MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
                                     w_ctx.unit_ctx()->prelude_conf.scope_access_operator ) );
 
             for ( auto &candidate : calls ) {
-                analyse_function_signature( c_ctx, w_ctx, candidate );
+                analyse_function_signature( c_ctx, t_ctx, w_ctx, candidate );
             }
 
             // TODO select the function based on its signature
 
             if ( calls.empty() ) {
                 w_ctx.print_msg<MessageType::err_operator_symbol_not_found>(
-                    MessageInfo( named[AstChild::itr], 0, FmtStr::Color::Red ), std::vector<MessageInfo>(), symbol_name,
-                    token.content );
+                    MessageInfo( named[AstChild::itr], 0, FmtStr::Color::Red ), std::vector<MessageInfo>(),
+                    symbol_name.str(), token.str() );
                 break;
             } else if ( calls.size() > 1 ) {
                 std::vector<MessageInfo> notes;
@@ -1386,150 +1403,155 @@ MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
                         notes.push_back( MessageInfo( *c_ctx.symbol_graph[c].original_expr.front(), 1 ) );
                 }
                 w_ctx.print_msg<MessageType::err_operator_symbol_is_ambiguous>(
-                    MessageInfo( named[AstChild::itr], 0, FmtStr::Color::Red ), notes, symbol_name, token.content );
+                    MessageInfo( named[AstChild::itr], 0, FmtStr::Color::Red ), notes, symbol_name.str(),
+                    token.str() );
                 break;
             }
 
             // Create iterator
-            right_result = named[AstChild::itr].named[AstChild::right_expr].parse_mir( c_ctx, w_ctx, func );
-            auto op_id = create_call( c_ctx, w_ctx, func, named[AstChild::itr], calls.front(), 0, { right_result } );
+            right_result = named[AstChild::itr].named[AstChild::right_expr].parse_mir( c_ctx, t_ctx, w_ctx, func );
+            auto op_id = create_call( c_ctx, t_ctx, w_ctx, func, named[AstChild::itr], calls.front(), 0,
+                                      { right_result } );
             iterator = c_ctx.functions[func].ops[op_id].ret;
             c_ctx.functions[func].vars[iterator].type =
                 MirVariable::Type::value; // TODO temporary workaround, while borrowing is not implemented (delete then)
         } else {
             // Iterate given iterator
-            iterator = named[AstChild::itr].parse_mir( c_ctx, w_ctx, func );
+            iterator = named[AstChild::itr].parse_mir( c_ctx, t_ctx, w_ctx, func );
         }
 
-        auto op_id = create_operation( c_ctx, w_ctx, func, named[AstChild::itr], MirEntry::Type::type, iterator, {} );
+        auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, named[AstChild::itr], MirEntry::Type::type, iterator,
+                                       {} );
         c_ctx.functions[func].ops[op_id].symbol = c_ctx.type_table[c_ctx.iterator_type].symbol;
 
         // Create loop jump label
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, loop_label, {} );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, loop_label, {} );
 
         // Loop condition
-        auto cond = create_call( c_ctx, w_ctx, func, named[AstChild::itr], c_ctx.type_table[c_ctx.itr_valid_fn].symbol,
-                                 0, { iterator } );
+        auto cond = create_call( c_ctx, t_ctx, w_ctx, func, named[AstChild::itr],
+                                 c_ctx.type_table[c_ctx.itr_valid_fn].symbol, 0, { iterator } );
 
-        op_id = create_operation( c_ctx, w_ctx, func, named[AstChild::itr], MirEntry::Type::bind, 0, { cond } );
-        drop_variable( c_ctx, w_ctx, func, named[AstChild::itr], cond );
+        op_id = create_operation( c_ctx, t_ctx, w_ctx, func, named[AstChild::itr], MirEntry::Type::bind, 0, { cond } );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, named[AstChild::itr], cond );
         cond = c_ctx.functions[func].ops[op_id].ret;
         c_ctx.functions[func].vars[cond].type =
             MirVariable::Type::not_dropped; // temporary var which must not be dropped
 
-        create_operation( c_ctx, w_ctx, func, named[AstChild::itr], MirEntry::Type::cond_jmp_z, end_label, { cond } );
+        create_operation( c_ctx, t_ctx, w_ctx, func, named[AstChild::itr], MirEntry::Type::cond_jmp_z, end_label,
+                          { cond } );
 
         // Create binding
         MirVarId binding = 0;
         if ( named[AstChild::itr].has_prop( ExprProperty::in_operator ) ) {
-            op_id = create_call( c_ctx, w_ctx, func, named[AstChild::itr], c_ctx.type_table[c_ctx.itr_get_fn].symbol, 0,
-                                 { iterator } );
+            op_id = create_call( c_ctx, t_ctx, w_ctx, func, named[AstChild::itr],
+                                 c_ctx.type_table[c_ctx.itr_get_fn].symbol, 0, { iterator } );
             binding = named[AstChild::itr].named[AstChild::left_expr].bind_vars(
-                c_ctx, w_ctx, func, c_ctx.functions[func].ops[op_id].ret, named[AstChild::itr], false );
+                c_ctx, t_ctx, w_ctx, func, c_ctx.functions[func].ops[op_id].ret, named[AstChild::itr], false );
         }
 
         // Body
-        auto body_var = children.front().parse_mir( c_ctx, w_ctx, func );
-        drop_variable( c_ctx, w_ctx, func, *this, body_var );
+        auto body_var = children.front().parse_mir( c_ctx, t_ctx, w_ctx, func );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, body_var );
 
         // Drop binding
         if ( binding != 0 ) {
-            drop_variable( c_ctx, w_ctx, func, *this, binding );
+            drop_variable( c_ctx, t_ctx, w_ctx, func, *this, binding );
         }
 
         // Increment iterator
-        op_id = create_call( c_ctx, w_ctx, func, *this, c_ctx.type_table[c_ctx.itr_next_fn].symbol, 0, { iterator } );
-        drop_variable( c_ctx, w_ctx, func, *this, c_ctx.functions[func].ops[op_id].ret );
+        op_id = create_call( c_ctx, t_ctx, w_ctx, func, *this, c_ctx.type_table[c_ctx.itr_next_fn].symbol, 0,
+                             { iterator } );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, c_ctx.functions[func].ops[op_id].ret );
 
         // Jump back loop
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::jmp, loop_label, {} );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::jmp, loop_label, {} );
 
         // Create end jump label
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, end_label, {} );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, end_label, {} );
 
         // Drop stuff
-        drop_variable( c_ctx, w_ctx, func, *this, iterator );
+        drop_variable( c_ctx, t_ctx, w_ctx, func, *this, iterator );
         if ( binding != 0 ) {
-            drop_variable( c_ctx, w_ctx, func, *this, right_result );
+            drop_variable( c_ctx, t_ctx, w_ctx, func, *this, right_result );
         }
 
         break; // return the unit var
     }
     case ExprType::match: {
-        auto selector = named[AstChild::select].parse_mir( c_ctx, w_ctx, func );
+        auto selector = named[AstChild::select].parse_mir( c_ctx, t_ctx, w_ctx, func );
 
-        ret = create_variable( c_ctx, w_ctx, func, this ); // will contain the final result
+        ret = create_variable( c_ctx, t_ctx, w_ctx, func, this ); // will contain the final result
 
-        auto end_label = create_variable( c_ctx, w_ctx, func, this );
+        auto end_label = create_variable( c_ctx, t_ctx, w_ctx, func, this );
         c_ctx.functions[func].vars[end_label].type = MirVariable::Type::label;
 
-        auto next_label = create_variable( c_ctx, w_ctx, func, this );
+        auto next_label = create_variable( c_ctx, t_ctx, w_ctx, func, this );
         c_ctx.functions[func].vars[next_label].type = MirVariable::Type::label;
         for ( auto &entry : children.front().children ) {
             // Jump label to this block and prepare next label
-            create_operation( c_ctx, w_ctx, func, entry, MirEntry::Type::label, next_label, {} );
-            next_label = create_variable( c_ctx, w_ctx, func, this ); // create next label
+            create_operation( c_ctx, t_ctx, w_ctx, func, entry, MirEntry::Type::label, next_label, {} );
+            next_label = create_variable( c_ctx, t_ctx, w_ctx, func, this ); // create next label
             c_ctx.functions[func].vars[next_label].type = MirVariable::Type::label;
 
             // Create a temporary copy of the selector, to avoid drop issues
             auto tmp_selector =
                 c_ctx.functions[func]
-                    .ops[create_operation( c_ctx, w_ctx, func, entry, MirEntry::Type::bind, 0, { selector } )]
+                    .ops[create_operation( c_ctx, t_ctx, w_ctx, func, entry, MirEntry::Type::bind, 0, { selector } )]
                     .ret;
 
             // Check if path matches
             auto check_var =
-                entry.named[AstChild::left_expr].check_deconstruction( c_ctx, w_ctx, func, tmp_selector, *this );
+                entry.named[AstChild::left_expr].check_deconstruction( c_ctx, t_ctx, w_ctx, func, tmp_selector, *this );
 
-            auto op_id = create_operation( c_ctx, w_ctx, func, entry, MirEntry::Type::bind, 0, { check_var } );
-            drop_variable( c_ctx, w_ctx, func, *this, check_var );
+            auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, entry, MirEntry::Type::bind, 0, { check_var } );
+            drop_variable( c_ctx, t_ctx, w_ctx, func, *this, check_var );
             check_var = c_ctx.functions[func].ops[op_id].ret;
             c_ctx.functions[func].vars[check_var].type =
                 MirVariable::Type::not_dropped; // temporary var which must not be dropped
 
-            create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, next_label, { check_var } );
+            create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, next_label, { check_var } );
 
             // Body (including the actual variable deconstruction)
-            entry.named[AstChild::left_expr].bind_vars( c_ctx, w_ctx, func, tmp_selector, *this, true );
-            auto result = entry.named[AstChild::right_expr].parse_mir( c_ctx, w_ctx, func );
-            create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::bind, ret, { result } );
-            drop_variable( c_ctx, w_ctx, func, *this, result );
+            entry.named[AstChild::left_expr].bind_vars( c_ctx, t_ctx, w_ctx, func, tmp_selector, *this, true );
+            auto result = entry.named[AstChild::right_expr].parse_mir( c_ctx, t_ctx, w_ctx, func );
+            create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::bind, ret, { result } );
+            drop_variable( c_ctx, t_ctx, w_ctx, func, *this, result );
 
             // Jump out
-            create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::jmp, end_label, {} );
+            create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::jmp, end_label, {} );
         }
         // last label (should never be reached)
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, next_label, {} );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, next_label, {} );
 
-        create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, end_label, {} );
+        create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, end_label, {} );
 
-        remove_from_local_living_vars( c_ctx, w_ctx, func, *this, selector );
+        remove_from_local_living_vars( c_ctx, t_ctx, w_ctx, func, *this, selector );
         break;
     }
     case ExprType::self: {
-        if ( c_ctx.curr_self_var == 0 ) {
+        if ( t_ctx.curr_self_var == 0 ) {
             w_ctx.print_msg<MessageType::err_self_in_free_function>( MessageInfo( *this, 0, FmtStr::Color::Red ) );
         }
-        ret = c_ctx.curr_self_var;
+        ret = t_ctx.curr_self_var;
         break;
     }
     case ExprType::self_type: {
-        if ( c_ctx.curr_self_type == 0 ) {
+        if ( t_ctx.curr_self_type == 0 ) {
             w_ctx.print_msg<MessageType::err_self_in_free_function>( MessageInfo( *this, 0, FmtStr::Color::Red ) );
         }
 
-        ret = create_variable( c_ctx, w_ctx, func, this );
+        ret = create_variable( c_ctx, t_ctx, w_ctx, func, this );
         auto &result_var = c_ctx.functions[func].vars[ret];
         result_var.type = MirVariable::Type::symbol;
-        result_var.value_type = c_ctx.curr_self_type;
+        result_var.value_type = t_ctx.curr_self_type;
 
         // Create cosmetic operation
-        auto op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::symbol, ret, {} );
-        c_ctx.functions[func].ops[op_id].symbol = c_ctx.type_table[c_ctx.curr_self_type].symbol;
+        auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::symbol, ret, {} );
+        c_ctx.functions[func].ops[op_id].symbol = c_ctx.type_table[t_ctx.curr_self_type].symbol;
         break;
     }
     case ExprType::struct_initializer: {
-        auto struct_var = named[AstChild::symbol].parse_mir( c_ctx, w_ctx, func );
+        auto struct_var = named[AstChild::symbol].parse_mir( c_ctx, t_ctx, w_ctx, func );
         if ( struct_var != 0 ) {
             // Symbol found
             auto &type = c_ctx.type_table[c_ctx.functions[func].vars[struct_var].value_type];
@@ -1542,7 +1564,7 @@ MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
             }
 
             // Create variable TODO handle mutability
-            ret = create_variable( c_ctx, w_ctx, func, this );
+            ret = create_variable( c_ctx, t_ctx, w_ctx, func, this );
             auto &result_var = c_ctx.functions[func].vars[ret];
             result_var.type = MirVariable::Type::rvalue;
             result_var.value_type = c_ctx.functions[func].vars[struct_var].value_type;
@@ -1561,31 +1583,31 @@ MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
             vars.reserve( type.members.size() );
             for ( size_t i = 0; i < type.members.size(); i++ ) {
                 auto &entry = children.front().children[i];
-                auto var = entry.parse_mir( c_ctx, w_ctx, func );
+                auto var = entry.parse_mir( c_ctx, t_ctx, w_ctx, func );
                 vars.push_back( var );
 
                 // Add type check operation TODO handle if struct member is not already typed
-                auto op_id = create_operation( c_ctx, w_ctx, func, entry, MirEntry::Type::type, var, {} );
+                auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, entry, MirEntry::Type::type, var, {} );
                 c_ctx.functions[func].ops[op_id].symbol = type.members[i].type;
             }
 
             // Merge values into type
-            create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::merge, ret, vars );
+            create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::merge, ret, vars );
 
             // Set type operation (should be after the merge)
-            auto op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::type, ret, {} );
+            auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::type, ret, {} );
             c_ctx.functions[func].ops[op_id].symbol = c_ctx.type_table[result_var.value_type].symbol;
 
             // Drop vars if necessary
             for ( auto var_itr = vars.rbegin(); var_itr != vars.rend(); var_itr++ ) {
-                drop_variable( c_ctx, w_ctx, func, children.front(), *var_itr );
+                drop_variable( c_ctx, t_ctx, w_ctx, func, children.front(), *var_itr );
             }
         }
 
         break;
     }
     case ExprType::member_access: {
-        auto obj = named[AstChild::base].parse_mir( c_ctx, w_ctx, func );
+        auto obj = named[AstChild::base].parse_mir( c_ctx, t_ctx, w_ctx, func );
         if ( obj == 0 ) {
             // Symbol not found (error message already generated)
             break;
@@ -1594,7 +1616,7 @@ MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
         auto base_symbol = c_ctx.type_table[c_ctx.functions[func].vars[obj].value_type].symbol;
 
         // Get member name
-        auto member_chain = named[AstChild::member].get_symbol_chain( c_ctx, w_ctx );
+        auto member_chain = named[AstChild::member].get_symbol_chain( c_ctx, t_ctx, w_ctx );
         if ( member_chain->size() != 1 || !member_chain->front().template_values.empty() ) {
             w_ctx.print_msg<MessageType::err_member_in_invalid_scope>(
                 MessageInfo( named[AstChild::member], 0, FmtStr::Color::Red ) );
@@ -1604,12 +1626,7 @@ MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
         auto attrs = find_member_symbol_by_identifier( c_ctx, w_ctx, member_chain->front(), base_symbol );
 
         // Find methods
-        std::vector<SymbolId> methods;
-        for ( auto &node : c_ctx.symbol_graph[base_symbol].sub_nodes ) {
-            if ( symbol_identifier_matches( member_chain->front(), c_ctx.symbol_graph[node].identifier ) ) {
-                methods.push_back( node );
-            }
-        }
+        auto methods = find_sub_symbol_by_identifier( c_ctx, w_ctx, member_chain->front(), base_symbol );
 
         if ( attrs.empty() && methods.empty() ) {
             w_ctx.print_msg<MessageType::err_symbol_not_found>(
@@ -1633,7 +1650,7 @@ MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
         // Create operation
         if ( !attrs.empty() ) {
             // Access attribute
-            auto op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::member, 0, { obj } );
+            auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::member, 0, { obj } );
             auto &result_var = c_ctx.functions[func].vars[c_ctx.functions[func].ops[op_id].ret];
             result_var.member_idx = attrs.front();
             result_var.type = MirVariable::Type::l_ref;
@@ -1662,31 +1679,31 @@ MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
                 break;
             }
 
-            ret = create_variable( c_ctx, w_ctx, func, this );
+            ret = create_variable( c_ctx, t_ctx, w_ctx, func, this );
             auto &result_var = c_ctx.functions[func].vars[ret];
             result_var.type = MirVariable::Type::symbol;
             result_var.value_type = c_ctx.symbol_graph[methods.front()].value;
             result_var.base_ref = obj;
 
             // Create cosmetic operation
-            auto op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::symbol, ret, { obj } );
+            auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::symbol, ret, { obj } );
             c_ctx.functions[func].ops[op_id].symbol = methods.front();
         }
         break;
     }
     case ExprType::typed_op: {
-        ret = named[AstChild::left_expr].parse_mir( c_ctx, w_ctx, func );
+        ret = named[AstChild::left_expr].parse_mir( c_ctx, t_ctx, w_ctx, func );
         if ( ret == 0 )
             break; // Error, don't do anything
 
         auto type_ids = find_local_symbol_by_identifier_chain(
-            c_ctx, w_ctx, named[AstChild::right_expr].get_symbol_chain( c_ctx, w_ctx ) );
+            c_ctx, t_ctx, w_ctx, named[AstChild::right_expr].get_symbol_chain( c_ctx, t_ctx, w_ctx ) );
 
         if ( !expect_exactly_one_symbol( c_ctx, w_ctx, type_ids, named[AstChild::right_expr] ) )
             break;
 
         // Set type
-        auto op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::type, ret, {} );
+        auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::type, ret, {} );
         c_ctx.functions[func].ops[op_id].symbol = type_ids.front();
         if ( c_ctx.functions[func].vars[ret].value_type == 0 ) {
             c_ctx.functions[func].vars[ret].value_type = c_ctx.symbol_graph[type_ids.front()].value;
@@ -1701,20 +1718,20 @@ MirVarId AstNode::parse_mir( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
 
     // Switch back to parent scope if needed
     if ( scope_symbol != 0 )
-        switch_scope_to_symbol( c_ctx, w_ctx, scope_symbol );
+        switch_scope_to_symbol( c_ctx, t_ctx, w_ctx, scope_symbol );
 
     return ret;
 }
 
-MirVarId AstNode::bind_vars( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func, MirVarId in_var, AstNode &bind_expr,
-                             bool checked_deconstruction ) {
+MirVarId AstNode::bind_vars( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, FunctionImplId func, MirVarId in_var,
+                             AstNode &bind_expr, bool checked_deconstruction ) {
     MirVarId ret = 0;
 
     switch ( type ) {
     case ExprType::op: {
         // Handle special logical operators and fall through otherwise
 
-        if ( token.content == "&&" ) { // TODO move this into the prelude
+        if ( token.str() == "&&" ) { // TODO move this into the prelude
             if ( !checked_deconstruction ) {
                 w_ctx.print_msg<MessageType::err_obj_deconstruction_check_expected>(
                     MessageInfo( *this, 0, FmtStr::Color::Red ) );
@@ -1722,20 +1739,21 @@ MirVarId AstNode::bind_vars( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
             }
 
             auto left_result =
-                named[AstChild::left_expr].bind_vars( c_ctx, w_ctx, func, in_var, bind_expr, checked_deconstruction );
+                named[AstChild::left_expr].bind_vars( c_ctx, t_ctx, w_ctx, func, in_var, bind_expr,
+                                                      checked_deconstruction );
             ret = left_result;
 
             break;
-        } else if ( token.content == "||" ) { // TODO move this into the prelude
+        } else if ( token.str() == "||" ) { // TODO move this into the prelude
             if ( !checked_deconstruction ) {
                 w_ctx.print_msg<MessageType::err_obj_deconstruction_check_expected>(
                     MessageInfo( *this, 0, FmtStr::Color::Red ) );
                 break;
             }
 
-            if ( named[AstChild::left_expr].bind_vars( c_ctx, w_ctx, func, in_var, bind_expr,
+            if ( named[AstChild::left_expr].bind_vars( c_ctx, t_ctx, w_ctx, func, in_var, bind_expr,
                                                        checked_deconstruction ) != 0 ||
-                 named[AstChild::right_expr].bind_vars( c_ctx, w_ctx, func, in_var, bind_expr,
+                 named[AstChild::right_expr].bind_vars( c_ctx, t_ctx, w_ctx, func, in_var, bind_expr,
                                                         checked_deconstruction ) != 0 ) {
                 w_ctx.print_msg<MessageType::err_feature_curr_not_supported>(
                     MessageInfo( *this, 0, FmtStr::Color::Red ), {}, String( "OR-operator in object deconstruction" ) );
@@ -1755,23 +1773,23 @@ MirVarId AstNode::bind_vars( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
     case ExprType::scope_access:
     case ExprType::array_access:
     case ExprType::template_postfix: {
-        remove_from_local_living_vars( c_ctx, w_ctx, func, *this, in_var );
+        remove_from_local_living_vars( c_ctx, t_ctx, w_ctx, func, *this, in_var );
         break; // allowed but return 0
     }
     case ExprType::atomic_symbol: {
         // Create an atomic binding
 
         // Get the symbol name
-        auto name_chain = get_symbol_chain( c_ctx, w_ctx );
+        auto name_chain = get_symbol_chain( c_ctx, t_ctx, w_ctx );
         if ( !expect_unscoped_variable( c_ctx, w_ctx, *name_chain, *this ) )
             break;
 
         // Create variable
-        ret = create_variable( c_ctx, w_ctx, func, this, name_chain->front().name );
+        ret = create_variable( c_ctx, t_ctx, w_ctx, func, this, name_chain->front().name );
 
         // Bind var
-        create_operation( c_ctx, w_ctx, func, bind_expr, MirEntry::Type::bind, ret, { in_var } );
-        remove_from_local_living_vars( c_ctx, w_ctx, func, *this, in_var );
+        create_operation( c_ctx, t_ctx, w_ctx, func, bind_expr, MirEntry::Type::bind, ret, { in_var } );
+        remove_from_local_living_vars( c_ctx, t_ctx, w_ctx, func, *this, in_var );
 
         c_ctx.functions[func].vars[ret].type = MirVariable::Type::value;
 
@@ -1781,7 +1799,7 @@ MirVarId AstNode::bind_vars( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
         // Deconstruct the object
 
         ret = in_var;
-        auto struct_var = named[AstChild::symbol].parse_mir( c_ctx, w_ctx, func );
+        auto struct_var = named[AstChild::symbol].parse_mir( c_ctx, t_ctx, w_ctx, func );
         if ( struct_var != 0 ) {
             // Symbol found
             auto &type = c_ctx.type_table[c_ctx.functions[func].vars[struct_var].value_type];
@@ -1805,7 +1823,8 @@ MirVarId AstNode::bind_vars( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
             // Bind member values
             for ( size_t i = 0; i < type.members.size(); i++ ) {
                 // Access the member
-                auto op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::member, 0, { in_var } );
+                auto op_id =
+                    create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::member, 0, { in_var } );
                 auto &result_var = c_ctx.functions[func].vars[c_ctx.functions[func].ops[op_id].ret];
                 result_var.member_idx = i;
                 result_var.type = MirVariable::Type::l_ref;
@@ -1821,10 +1840,10 @@ MirVarId AstNode::bind_vars( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
 
                 // Bind var
                 auto &entry = children.front().children[i];
-                entry.bind_vars( c_ctx, w_ctx, func, c_ctx.functions[func].ops[op_id].ret, *this,
+                entry.bind_vars( c_ctx, t_ctx, w_ctx, func, c_ctx.functions[func].ops[op_id].ret, *this,
                                  checked_deconstruction );
             }
-            remove_from_local_living_vars( c_ctx, w_ctx, func, *this, in_var );
+            remove_from_local_living_vars( c_ctx, t_ctx, w_ctx, func, *this, in_var );
         }
 
         break;
@@ -1832,18 +1851,19 @@ MirVarId AstNode::bind_vars( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
     case ExprType::typed_op: {
         // Pass binding and add type
 
-        ret = named[AstChild::left_expr].bind_vars( c_ctx, w_ctx, func, in_var, bind_expr, checked_deconstruction );
+        ret = named[AstChild::left_expr].bind_vars( c_ctx, t_ctx, w_ctx, func, in_var, bind_expr,
+                                                    checked_deconstruction );
         if ( ret == 0 )
             break; // Error, don't do anything
 
         auto type_ids = find_local_symbol_by_identifier_chain(
-            c_ctx, w_ctx, named[AstChild::right_expr].get_symbol_chain( c_ctx, w_ctx ) );
+            c_ctx, t_ctx, w_ctx, named[AstChild::right_expr].get_symbol_chain( c_ctx, t_ctx, w_ctx ) );
 
         if ( !expect_exactly_one_symbol( c_ctx, w_ctx, type_ids, named[AstChild::right_expr] ) )
             break;
 
         // Set type
-        auto op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::type, ret, {} );
+        auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::type, ret, {} );
         c_ctx.functions[func].ops[op_id].symbol = type_ids.front();
         if ( c_ctx.functions[func].vars[ret].value_type == 0 ) {
             c_ctx.functions[func].vars[ret].value_type = c_ctx.symbol_graph[type_ids.front()].value;
@@ -1868,99 +1888,104 @@ MirVarId AstNode::bind_vars( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
     return ret;
 }
 
-MirVarId AstNode::check_deconstruction( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func, MirVarId in_var,
-                                        AstNode &bind_expr ) {
+MirVarId AstNode::check_deconstruction( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, FunctionImplId func,
+                                        MirVarId in_var, AstNode &bind_expr ) {
     MirVarId ret = 0;
 
     switch ( type ) {
     case ExprType::op: {
         // Handle special logical operators and fall through otherwise
 
-        if ( token.content == "&&" ) { // TODO move this into the prelude
-            MirVarId eval_false_label = create_variable( c_ctx, w_ctx, func, this );
+        if ( token.str() == "&&" ) { // TODO move this into the prelude
+            MirVarId eval_false_label = create_variable( c_ctx, t_ctx, w_ctx, func, this );
             c_ctx.functions[func].vars[eval_false_label].type = MirVariable::Type::label;
 
-            auto left_result = named[AstChild::left_expr].check_deconstruction( c_ctx, w_ctx, func, in_var, bind_expr );
+            auto left_result = named[AstChild::left_expr].check_deconstruction( c_ctx, t_ctx, w_ctx, func, in_var,
+                                                                                bind_expr );
             if ( left_result != 0 ) {
-                create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, eval_false_label,
+                create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, eval_false_label,
                                   { left_result } );
             }
 
-            auto right_result = named[AstChild::right_expr].parse_mir( c_ctx, w_ctx, func );
-            auto op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::bind, 0, { right_result } );
-            drop_variable( c_ctx, w_ctx, func, *this, right_result );
+            auto right_result = named[AstChild::right_expr].parse_mir( c_ctx, t_ctx, w_ctx, func );
+            auto op_id =
+                create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::bind, 0, { right_result } );
+            drop_variable( c_ctx, t_ctx, w_ctx, func, *this, right_result );
             right_result = c_ctx.functions[func].ops[op_id].ret;
             c_ctx.functions[func].vars[right_result].type =
                 MirVariable::Type::not_dropped; // temporary var which must not be dropped
 
-            create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, eval_false_label,
+            create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, eval_false_label,
                               { right_result } );
 
             // Create check conclusion
-            op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::literal, 0, {} );
+            op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::literal, 0, {} );
             c_ctx.functions[func].ops[op_id].data = c_ctx.true_val;
             ret = c_ctx.functions[func].ops[op_id].ret;
 
-            auto eval_end_label = create_variable( c_ctx, w_ctx, func, this );
+            auto eval_end_label = create_variable( c_ctx, t_ctx, w_ctx, func, this );
             c_ctx.functions[func].vars[eval_end_label].type = MirVariable::Type::label;
-            create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::jmp, eval_end_label, {} );
+            create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::jmp, eval_end_label, {} );
 
-            create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, eval_false_label, {} );
-            op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::literal, ret, {} );
+            create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, eval_false_label, {} );
+            op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::literal, ret, {} );
             c_ctx.functions[func].ops[op_id].data = c_ctx.false_val;
 
-            create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, eval_end_label, {} );
-            drop_variable( c_ctx, w_ctx, func, *this, left_result );
+            create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, eval_end_label, {} );
+            drop_variable( c_ctx, t_ctx, w_ctx, func, *this, left_result );
 
             break;
-        } else if ( token.content == "||" ) { // TODO move this into the prelude
-            MirVarId eval_true_label = create_variable( c_ctx, w_ctx, func, this );
+        } else if ( token.str() == "||" ) { // TODO move this into the prelude
+            MirVarId eval_true_label = create_variable( c_ctx, t_ctx, w_ctx, func, this );
             c_ctx.functions[func].vars[eval_true_label].type = MirVariable::Type::label;
 
             // Evaluate left
-            auto left_result = named[AstChild::left_expr].check_deconstruction( c_ctx, w_ctx, func, in_var, bind_expr );
+            auto left_result = named[AstChild::left_expr].check_deconstruction( c_ctx, t_ctx, w_ctx, func, in_var,
+                                                                                bind_expr );
 
             if ( left_result != 0 ) {
-                auto op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::inv, 0, { left_result } );
-                create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, eval_true_label,
+                auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::inv, 0,
+                                               { left_result } );
+                create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, eval_true_label,
                                   { c_ctx.functions[func].ops[op_id].ret } );
             } else { // always true
-                create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::jmp, eval_true_label, {} );
+                create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::jmp, eval_true_label, {} );
             }
 
             // Evaluate right
             auto right_result =
-                named[AstChild::right_expr].check_deconstruction( c_ctx, w_ctx, func, in_var, bind_expr );
+                named[AstChild::right_expr].check_deconstruction( c_ctx, t_ctx, w_ctx, func, in_var, bind_expr );
 
             if ( right_result != 0 ) {
-                auto op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::inv, 0, { right_result } );
-                drop_variable( c_ctx, w_ctx, func, *this, right_result );
+                auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::inv, 0,
+                                               { right_result } );
+                drop_variable( c_ctx, t_ctx, w_ctx, func, *this, right_result );
                 c_ctx.functions[func].vars[c_ctx.functions[func].ops[op_id].ret].type =
                     MirVariable::Type::not_dropped; // temporary var which must not be dropped
-                create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, eval_true_label,
+                create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, eval_true_label,
                                   { c_ctx.functions[func].ops[op_id].ret } );
             } else { // always true
-                create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::jmp, eval_true_label, {} );
+                create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::jmp, eval_true_label, {} );
             }
 
             // Create check conclusion
-            auto op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::literal, 0, {} );
+            auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::literal, 0, {} );
             c_ctx.functions[func].ops[op_id].data = c_ctx.false_val;
             ret = c_ctx.functions[func].ops[op_id].ret;
 
-            auto eval_end_label = create_variable( c_ctx, w_ctx, func, this );
+            auto eval_end_label = create_variable( c_ctx, t_ctx, w_ctx, func, this );
             c_ctx.functions[func].vars[eval_end_label].type = MirVariable::Type::label;
-            create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::jmp, eval_end_label, {} );
+            create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::jmp, eval_end_label, {} );
 
-            create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, eval_true_label, {} );
+            create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, eval_true_label, {} );
 
-            op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::literal, ret, {} );
+            op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::literal, ret, {} );
             c_ctx.functions[func].ops[op_id].data = c_ctx.true_val;
 
-            create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, eval_end_label, {} );
+            create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, eval_end_label, {} );
 
             if ( left_result != 0 )
-                drop_variable( c_ctx, w_ctx, func, *this, left_result );
+                drop_variable( c_ctx, t_ctx, w_ctx, func, *this, left_result );
             break;
         }
 
@@ -1979,22 +2004,23 @@ MirVarId AstNode::check_deconstruction( CrateCtx &c_ctx, Worker &w_ctx, Function
         // Check if the variable holds a specific value
 
         // Generate the expr
-        auto var = parse_mir( c_ctx, w_ctx, func );
+        auto var = parse_mir( c_ctx, t_ctx, w_ctx, func );
 
         // Check value
         auto op_id =
-            create_call( c_ctx, w_ctx, func, *this, c_ctx.type_table[c_ctx.equals_fn].symbol, 0, { in_var, var } );
+            create_call( c_ctx, t_ctx, w_ctx, func, *this, c_ctx.type_table[c_ctx.equals_fn].symbol, 0,
+                         { in_var, var } );
         ret = c_ctx.functions[func].ops[op_id].ret;
         break;
     }
     case ExprType::atomic_symbol: {
-        auto op_id = create_operation( c_ctx, w_ctx, func, bind_expr, MirEntry::Type::literal, 0, {} );
+        auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, bind_expr, MirEntry::Type::literal, 0, {} );
         c_ctx.functions[func].ops[op_id].data = c_ctx.true_val;
         ret = c_ctx.functions[func].ops[op_id].ret;
         break;
     }
     case ExprType::struct_initializer: {
-        auto struct_var = named[AstChild::symbol].parse_mir( c_ctx, w_ctx, func );
+        auto struct_var = named[AstChild::symbol].parse_mir( c_ctx, t_ctx, w_ctx, func );
         if ( struct_var != 0 ) {
             // Symbol found
             auto &type = c_ctx.type_table[c_ctx.functions[func].vars[struct_var].value_type];
@@ -2015,13 +2041,14 @@ MirVarId AstNode::check_deconstruction( CrateCtx &c_ctx, Worker &w_ctx, Function
                 break;
             }
 
-            MirVarId eval_false_label = create_variable( c_ctx, w_ctx, func, this );
+            MirVarId eval_false_label = create_variable( c_ctx, t_ctx, w_ctx, func, this );
             c_ctx.functions[func].vars[eval_false_label].type = MirVariable::Type::label;
 
             // Bind member values
             for ( size_t i = 0; i < type.members.size(); i++ ) {
                 // Access the member
-                auto op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::member, 0, { in_var } );
+                auto op_id =
+                    create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::member, 0, { in_var } );
                 auto &result_var = c_ctx.functions[func].vars[c_ctx.functions[func].ops[op_id].ret];
                 result_var.member_idx = i;
                 result_var.type = MirVariable::Type::l_ref;
@@ -2037,35 +2064,36 @@ MirVarId AstNode::check_deconstruction( CrateCtx &c_ctx, Worker &w_ctx, Function
 
                 // Check deconstruction
                 auto &entry = children.front().children[i];
-                auto binding =
-                    entry.check_deconstruction( c_ctx, w_ctx, func, c_ctx.functions[func].ops[op_id].ret, *this );
+                auto binding = entry.check_deconstruction( c_ctx, t_ctx, w_ctx, func,
+                                                           c_ctx.functions[func].ops[op_id].ret, *this );
 
                 // Handle check
                 if ( binding != 0 ) {
-                    auto op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::bind, 0, { binding } );
-                    drop_variable( c_ctx, w_ctx, func, *this, binding );
+                    auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::bind, 0,
+                                                   { binding } );
+                    drop_variable( c_ctx, t_ctx, w_ctx, func, *this, binding );
                     binding = c_ctx.functions[func].ops[op_id].ret;
                     c_ctx.functions[func].vars[binding].type =
                         MirVariable::Type::not_dropped; // temporary var which must not be dropped
-                    create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, eval_false_label,
+                    create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::cond_jmp_z, eval_false_label,
                                       { binding } );
                 }
             }
 
             // Create check conclusion
-            auto op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::literal, 0, {} );
+            auto op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::literal, 0, {} );
             c_ctx.functions[func].ops[op_id].data = c_ctx.true_val;
             ret = c_ctx.functions[func].ops[op_id].ret;
 
-            auto eval_end_label = create_variable( c_ctx, w_ctx, func, this );
+            auto eval_end_label = create_variable( c_ctx, t_ctx, w_ctx, func, this );
             c_ctx.functions[func].vars[eval_end_label].type = MirVariable::Type::label;
-            create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::jmp, eval_end_label, {} );
+            create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::jmp, eval_end_label, {} );
 
-            create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, eval_false_label, {} );
-            op_id = create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::literal, ret, {} );
+            create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, eval_false_label, {} );
+            op_id = create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::literal, ret, {} );
             c_ctx.functions[func].ops[op_id].data = c_ctx.false_val;
 
-            create_operation( c_ctx, w_ctx, func, *this, MirEntry::Type::label, eval_end_label, {} );
+            create_operation( c_ctx, t_ctx, w_ctx, func, *this, MirEntry::Type::label, eval_end_label, {} );
         }
 
         break;
@@ -2081,18 +2109,35 @@ MirVarId AstNode::check_deconstruction( CrateCtx &c_ctx, Worker &w_ctx, Function
 
 
 String AstNode::get_debug_repr() const {
+    // The representations are composed bottom-up, so that deep ASTs don't need deep recursion
+    using SubReprs = std::unordered_map<const AstNode *, String>;
+    SubReprs root_reprs;
+    walk_ast(
+        *this, root_reprs,
+        []( const AstNode &node, SubReprs &parent_reprs ) { return std::optional<SubReprs>( SubReprs() ); },
+        []( const AstNode &node, SubReprs &sub_reprs, SubReprs &parent_reprs ) {
+            parent_reprs[&node] = node.compose_debug_repr( sub_reprs );
+        } );
+    return root_reprs[this];
+}
+
+String AstNode::compose_debug_repr( const std::unordered_map<const AstNode *, String> &sub_reprs ) const {
+    auto repr = [&]( const AstNode &sub ) -> const String & { return sub_reprs.at( &sub ); };
+
+    const AstNodePayload empty_payload;
+    auto &payload = get_payload() ? *get_payload() : empty_payload;
     String add_debug_data;
-    if ( !annotations.empty() ) {
+    if ( !payload.annotations.empty() ) {
         add_debug_data += "#(";
-        for ( auto &a : annotations ) {
-            add_debug_data += a.get_debug_repr() + ", ";
+        for ( auto &a : payload.annotations ) {
+            add_debug_data += repr( a ) + ", ";
         }
         add_debug_data += ")";
     }
-    if ( !static_statements.empty() ) {
+    if ( !payload.static_statements.empty() ) {
         add_debug_data += "$(";
-        for ( auto &stst : static_statements ) {
-            add_debug_data += stst.get_debug_repr() + ", ";
+        for ( auto &stst : payload.static_statements ) {
+            add_debug_data += repr( stst ) + ", ";
         }
         add_debug_data += ")";
     }
@@ -2100,133 +2145,133 @@ String AstNode::get_debug_repr() const {
     String str;
     switch ( type ) {
     case ExprType::token:
-        return "TOKEN " + to_string( static_cast<int>( token.type ) ) + " \"" + token.content + "\" " + add_debug_data;
+        return "TOKEN " + to_string( static_cast<int>( token_type ) ) + " \"" + token.str() + "\" " + add_debug_data;
 
     case ExprType::decl_scope:
         str = "GLOBAL {\n ";
         for ( auto &child : children )
-            str += child.get_debug_repr() + "\n ";
+            str += repr( child ) + "\n ";
         return str + " }" + add_debug_data;
     case ExprType::imp_scope:
         str = "IMP {\n ";
         for ( auto &child : children )
-            str += child.get_debug_repr() + "\n ";
+            str += repr( child ) + "\n ";
         return str + " }" + add_debug_data;
     case ExprType::single_completed:
-        return "SC " + children.front().get_debug_repr() + ";" + add_debug_data;
+        return "SC " + repr( children.front() ) + ";" + add_debug_data;
     case ExprType::block:
         str = "BLOCK {\n ";
         for ( auto &child : children )
-            str += child.get_debug_repr() + "\n ";
+            str += repr( child ) + "\n ";
         return str + " }" + add_debug_data;
     case ExprType::set:
         str = "SET { ";
         for ( auto &child : children )
-            str += child.get_debug_repr() + ", ";
+            str += repr( child ) + ", ";
         return str + "}" + add_debug_data;
     case ExprType::unit:
         return "UNIT()";
     case ExprType::term:
-        return "TERM( " + children.front().get_debug_repr() + " )" + add_debug_data;
+        return "TERM( " + repr( children.front() ) + " )" + add_debug_data;
     case ExprType::tuple:
         str = "TUPLE( ";
         for ( auto &child : children )
-            str += child.get_debug_repr() + ", ";
+            str += repr( child ) + ", ";
         return str + ")" + add_debug_data;
     case ExprType::array_specifier:
         str = "ARRAY[ ";
         for ( auto &child : children )
-            str += child.get_debug_repr();
+            str += repr( child );
         return str + " ]" + add_debug_data;
     case ExprType::array_list:
         str = "ARRAY_LIST[ ";
         for ( auto &child : children )
-            str += child.get_debug_repr();
+            str += repr( child );
         return str + " ]" + add_debug_data;
     case ExprType::comma_list:
         str = "COMMA( ";
         for ( auto &child : children )
-            str += child.get_debug_repr() + ", ";
+            str += repr( child ) + ", ";
         return str + ")" + add_debug_data;
     case ExprType::numeric_literal:
         return "BLOB_LITERAL(" + to_string( literal_number ) + ")" + add_debug_data;
     case ExprType::string_literal:
-        return "STR \"" + literal_string + "\"" + add_debug_data;
+        return "STR \"" + payload.literal_string + "\"" + add_debug_data;
 
     case ExprType::atomic_symbol:
-        return "SYM(" + to_string( symbol ) + " " + symbol_name + ")" + add_debug_data;
+        return "SYM(" + to_string( symbol ) + " " + symbol_name.str() + ")" + add_debug_data;
     case ExprType::func_head:
         return "FUNC_HEAD(" +
                ( named.find( AstChild::parameters ) != named.end()
-                     ? named.at( AstChild::parameters ).get_debug_repr() + " "
+                     ? repr( named.at( AstChild::parameters ) ) + " "
                      : "" ) +
-               named.at( AstChild::symbol ).get_debug_repr() + ")" + add_debug_data;
+               repr( named.at( AstChild::symbol ) ) + ")" + add_debug_data;
     case ExprType::func:
         return "FUNC(" +
                ( named.find( AstChild::parameters ) != named.end()
-                     ? named.at( AstChild::parameters ).get_debug_repr() + " "
+                     ? repr( named.at( AstChild::parameters ) ) + " "
                      : "" ) +
-               ( named.find( AstChild::symbol ) != named.end() ? named.at( AstChild::symbol ).get_debug_repr()
+               ( named.find( AstChild::symbol ) != named.end() ? repr( named.at( AstChild::symbol ) )
                                                                : "<anonymous>" ) +
                ( named.find( AstChild::return_type ) != named.end()
-                     ? " -> " + named.at( AstChild::return_type ).get_debug_repr()
+                     ? " -> " + repr( named.at( AstChild::return_type ) )
                      : "" ) +
-               " " + children.front().get_debug_repr() + ")" + add_debug_data;
+               " " + repr( children.front() ) + ")" + add_debug_data;
     case ExprType::func_decl:
         return "FUNC_DECL(" +
                ( named.find( AstChild::parameters ) != named.end()
-                     ? named.at( AstChild::parameters ).get_debug_repr() + " "
+                     ? repr( named.at( AstChild::parameters ) ) + " "
                      : "" ) +
-               named.at( AstChild::symbol ).get_debug_repr() + ")" + add_debug_data;
+               repr( named.at( AstChild::symbol ) ) + ")" + add_debug_data;
     case ExprType::func_call:
         return "FN_CALL(" +
                ( named.find( AstChild::parameters ) != named.end()
-                     ? named.at( AstChild::parameters ).get_debug_repr() + " "
+                     ? repr( named.at( AstChild::parameters ) ) + " "
                      : "" ) +
-               named.at( AstChild::symbol ).get_debug_repr() + ")" + add_debug_data;
+               repr( named.at( AstChild::symbol ) ) + ")" + add_debug_data;
 
     case ExprType::op:
         return "OP(" +
                ( named.find( AstChild::left_expr ) != named.end()
-                     ? named.at( AstChild::left_expr ).get_debug_repr() + " "
+                     ? repr( named.at( AstChild::left_expr ) ) + " "
                      : "" ) +
-               token.content +
+               token.str() +
                ( named.find( AstChild::right_expr ) != named.end()
-                     ? " " + named.at( AstChild::right_expr ).get_debug_repr()
+                     ? " " + repr( named.at( AstChild::right_expr ) )
                      : "" ) +
                ")" + add_debug_data;
     case ExprType::simple_bind:
-        return "BINDING(" + children.front().get_debug_repr() + ")" + add_debug_data;
+        return "BINDING(" + repr( children.front() ) + ")" + add_debug_data;
     case ExprType::alias_bind:
-        return "ALIAS(" + children.front().get_debug_repr() + ")" + add_debug_data;
+        return "ALIAS(" + repr( children.front() ) + ")" + add_debug_data;
     case ExprType::if_bind:
-        return "IF_BIND(" + named.at( AstChild::cond ).get_debug_repr() + " THEN " + children.front().get_debug_repr() +
+        return "IF_BIND(" + repr( named.at( AstChild::cond ) ) + " THEN " + repr( children.front() ) +
                " )" + add_debug_data;
     case ExprType::if_else_bind:
-        return "IF_BIND(" + named.at( AstChild::cond ).get_debug_repr() + " THEN " + children.front().get_debug_repr() +
-               " ELSE " + children.at( 1 ).get_debug_repr() + " )" + add_debug_data;
+        return "IF_BIND(" + repr( named.at( AstChild::cond ) ) + " THEN " + repr( children.front() ) +
+               " ELSE " + repr( children.at( 1 ) ) + " )" + add_debug_data;
 
     case ExprType::if_cond:
-        return "IF(" + named.at( AstChild::cond ).get_debug_repr() + " THEN " + children.front().get_debug_repr() +
+        return "IF(" + repr( named.at( AstChild::cond ) ) + " THEN " + repr( children.front() ) +
                " )" + add_debug_data;
     case ExprType::if_else:
-        return "IF(" + named.at( AstChild::cond ).get_debug_repr() + " THEN " + children.front().get_debug_repr() +
-               " ELSE " + children.at( 1 ).get_debug_repr() + " )" + add_debug_data;
+        return "IF(" + repr( named.at( AstChild::cond ) ) + " THEN " + repr( children.front() ) +
+               " ELSE " + repr( children.at( 1 ) ) + " )" + add_debug_data;
     case ExprType::pre_loop:
         return "PRE_LOOP(" + String( continue_eval ? "TRUE: " : "FALSE: " ) +
-               named.at( AstChild::cond ).get_debug_repr() + " DO " + children.front().get_debug_repr() + " )" +
+               repr( named.at( AstChild::cond ) ) + " DO " + repr( children.front() ) + " )" +
                add_debug_data;
     case ExprType::post_loop:
         return "POST_LOOP(" + String( continue_eval ? "TRUE: " : "FALSE: " ) +
-               named.at( AstChild::cond ).get_debug_repr() + " DO " + children.front().get_debug_repr() + " )" +
+               repr( named.at( AstChild::cond ) ) + " DO " + repr( children.front() ) + " )" +
                add_debug_data;
     case ExprType::inf_loop:
-        return "INF_LOOP(" + children.front().get_debug_repr() + " )" + add_debug_data;
+        return "INF_LOOP(" + repr( children.front() ) + " )" + add_debug_data;
     case ExprType::itr_loop:
-        return "ITR_LOOP(" + named.at( AstChild::itr ).get_debug_repr() + " DO " + children.front().get_debug_repr() +
+        return "ITR_LOOP(" + repr( named.at( AstChild::itr ) ) + " DO " + repr( children.front() ) +
                " )" + add_debug_data;
     case ExprType::match:
-        return "MATCH(" + named.at( AstChild::select ).get_debug_repr() + " WITH " + children.front().get_debug_repr() +
+        return "MATCH(" + repr( named.at( AstChild::select ) ) + " WITH " + repr( children.front() ) +
                ")" + add_debug_data;
 
     case ExprType::self:
@@ -2234,38 +2279,38 @@ String AstNode::get_debug_repr() const {
     case ExprType::self_type:
         return "SELF_TYPE" + add_debug_data;
     case ExprType::struct_initializer:
-        return "STRUCT_INIT(" + named.at( AstChild::symbol ).get_debug_repr() + " " +
-               children.front().get_debug_repr() + ")" + add_debug_data;
+        return "STRUCT_INIT(" + repr( named.at( AstChild::symbol ) ) + " " +
+               repr( children.front() ) + ")" + add_debug_data;
 
     case ExprType::structure:
         return "STRUCT " +
-               ( named.find( AstChild::symbol ) != named.end() ? named.at( AstChild::symbol ).get_debug_repr()
+               ( named.find( AstChild::symbol ) != named.end() ? repr( named.at( AstChild::symbol ) )
                                                                : "<anonymous>" ) +
-               " " + ( !children.empty() ? children.front().get_debug_repr() : "<undefined>" ) + add_debug_data;
+               " " + ( !children.empty() ? repr( children.front() ) : "<undefined>" ) + add_debug_data;
     case ExprType::trait:
-        return "TRAIT " + named.at( AstChild::symbol ).get_debug_repr() + " " + children.front().get_debug_repr() +
+        return "TRAIT " + repr( named.at( AstChild::symbol ) ) + " " + repr( children.front() ) +
                add_debug_data;
     case ExprType::implementation:
         if ( named.find( AstChild::trait_symbol ) != named.end() ) {
-            return "IMPL " + named.at( AstChild::trait_symbol ).get_debug_repr() + " FOR " +
-                   named.at( AstChild::struct_symbol ).get_debug_repr() + " " + children.front().get_debug_repr() +
+            return "IMPL " + repr( named.at( AstChild::trait_symbol ) ) + " FOR " +
+                   repr( named.at( AstChild::struct_symbol ) ) + " " + repr( children.front() ) +
                    add_debug_data;
         } else {
-            return "IMPL " + named.at( AstChild::struct_symbol ).get_debug_repr() + " " +
-                   children.front().get_debug_repr() + add_debug_data;
+            return "IMPL " + repr( named.at( AstChild::struct_symbol ) ) + " " +
+                   repr( children.front() ) + add_debug_data;
         }
 
     case ExprType::member_access:
-        return "MEMBER(" + named.at( AstChild::base ).get_debug_repr() + "." +
-               named.at( AstChild::member ).get_debug_repr() + ")" + add_debug_data;
+        return "MEMBER(" + repr( named.at( AstChild::base ) ) + "." +
+               repr( named.at( AstChild::member ) ) + ")" + add_debug_data;
     case ExprType::scope_access:
         return "SCOPE(" +
-               ( named.find( AstChild::base ) != named.end() ? named.at( AstChild::base ).get_debug_repr()
+               ( named.find( AstChild::base ) != named.end() ? repr( named.at( AstChild::base ) )
                                                              : "<global>" ) +
-               "::" + named.at( AstChild::member ).get_debug_repr() + ")" + add_debug_data;
+               "::" + repr( named.at( AstChild::member ) ) + ")" + add_debug_data;
     case ExprType::array_access:
-        return "ARR_ACC " + named.at( AstChild::base ).get_debug_repr() + "[" +
-               named.at( AstChild::index ).get_debug_repr() + "]" + add_debug_data;
+        return "ARR_ACC " + repr( named.at( AstChild::base ) ) + "[" +
+               repr( named.at( AstChild::index ) ) + "]" + add_debug_data;
 
     case ExprType::range:
         str = range_type == Operator::RangeOperatorType::exclude
@@ -2278,42 +2323,42 @@ String AstNode::get_debug_repr() const {
                                     ? "INCLUDE"
                                     : range_type == Operator::RangeOperatorType::include_to ? "INCLUDE_TO" : "INVALID";
         return "RANGE " + str + " " +
-               ( named.find( AstChild::from ) != named.end() ? named.at( AstChild::from ).get_debug_repr() : "" ) +
+               ( named.find( AstChild::from ) != named.end() ? repr( named.at( AstChild::from ) ) : "" ) +
                ( named.find( AstChild::from ) != named.end() && named.find( AstChild::to ) != named.end() ? ".."
                                                                                                           : "" ) +
-               ( named.find( AstChild::to ) != named.end() ? named.at( AstChild::to ).get_debug_repr() : "" ) +
+               ( named.find( AstChild::to ) != named.end() ? repr( named.at( AstChild::to ) ) : "" ) +
                add_debug_data;
     case ExprType::reference:
-        return "REF(" + named.at( AstChild::symbol_like ).get_debug_repr() + ")" + add_debug_data;
+        return "REF(" + repr( named.at( AstChild::symbol_like ) ) + ")" + add_debug_data;
     case ExprType::mutable_attr:
-        return "MUT(" + named.at( AstChild::symbol_like ).get_debug_repr() + ")" + add_debug_data;
+        return "MUT(" + repr( named.at( AstChild::symbol_like ) ) + ")" + add_debug_data;
     case ExprType::typeof_op:
-        return "TYPE_OF(" + children.front().get_debug_repr() + ")" + add_debug_data;
+        return "TYPE_OF(" + repr( children.front() ) + ")" + add_debug_data;
     case ExprType::typed_op:
-        return "TYPED(" + named.at( AstChild::left_expr ).get_debug_repr() + ":" +
-               named.at( AstChild::right_expr ).get_debug_repr() + ")" + add_debug_data;
+        return "TYPED(" + repr( named.at( AstChild::left_expr ) ) + ":" +
+               repr( named.at( AstChild::right_expr ) ) + ")" + add_debug_data;
 
     case ExprType::module:
-        return "MODULE " + named.at( AstChild::symbol ).get_debug_repr() + " " + children.front().get_debug_repr() +
+        return "MODULE " + repr( named.at( AstChild::symbol ) ) + " " + repr( children.front() ) +
                add_debug_data;
     case ExprType::declaration:
-        return "DECL(" + children.front().get_debug_repr() + ")" + add_debug_data;
+        return "DECL(" + repr( children.front() ) + ")" + add_debug_data;
     case ExprType::public_attr:
-        return "PUBLIC(" + children.front().get_debug_repr() + ")" + add_debug_data;
+        return "PUBLIC(" + repr( children.front() ) + ")" + add_debug_data;
     case ExprType::static_statement:
-        return "STST " + children.front().get_debug_repr() + add_debug_data;
+        return "STST " + repr( children.front() ) + add_debug_data;
     case ExprType::compiler_annotation:
-        return "ANNOTATE(" + named.at( AstChild::symbol ).get_debug_repr() + " " +
-               named.at( AstChild::parameters ).get_debug_repr() + ")" + add_debug_data;
+        return "ANNOTATE(" + repr( named.at( AstChild::symbol ) ) + " " +
+               repr( named.at( AstChild::parameters ) ) + ")" + add_debug_data;
     case ExprType::macro_call:
-        return "MACRO(" + named.at( AstChild::symbol ).get_debug_repr() + "! " + children.front().get_debug_repr() +
+        return "MACRO(" + repr( named.at( AstChild::symbol ) ) + "! " + repr( children.front() ) +
                ")" + add_debug_data;
     case ExprType::unsafe:
-        return "UNSAFE " + children.front().get_debug_repr() + add_debug_data;
+        return "UNSAFE " + repr( children.front() ) + add_debug_data;
     case ExprType::template_postfix:
-        str = "TEMPLATE " + named.at( AstChild::symbol ).get_debug_repr() + "<";
+        str = "TEMPLATE " + repr( named.at( AstChild::symbol ) ) + "<";
         for ( auto &child : children )
-            str += child.get_debug_repr() + ", ";
+            str += repr( child ) + ", ";
         return str + " >" + add_debug_data;
 
     default:
@@ -31,8 +31,15 @@ void link_binary( const String &out_file, JobsBuilder &jb, UnitCtx &parent_ctx )
         auto jc = w_ctx.do_query( get_compilation_units );
         auto units = jc->jobs.front()->to<std::vector<String>>();
 
+        // Read all sources in the background while the units are compiled
+        auto files = units;
+        auto prelude_files = get_prelude_files();
+        files.insert( files.end(), prelude_files.begin(), prelude_files.end() );
+        auto prefetch = w_ctx.query( prefetch_source_files, files );
+
         for ( auto &unit : units ) {
             w_ctx.do_query( build_unit, unit );
         }
+        prefetch->execute( w_ctx )->wait();
     } );
 }
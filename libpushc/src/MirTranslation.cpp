@@ -18,17 +18,18 @@
 #include "libpushc/SymbolUtil.h"
 
 
-MirEntryId create_operation( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId function, AstNode &original_expr,
-                             MirEntry::Type type, MirVarId result, std::vector<MirVarId> parameters ) {
+MirEntryId create_operation( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, FunctionImplId function,
+                             AstNode &original_expr, MirEntry::Type type, MirVarId result,
+                             std::vector<MirVarId> parameters ) {
     MirVarId return_var = result;
     if ( result == 0 ) {
-        return_var = create_variable( c_ctx, w_ctx, function, &original_expr, "" );
+        return_var = create_variable( c_ctx, t_ctx, w_ctx, function, &original_expr, "" );
     }
 
     // Check if parameters are valid
     for ( auto &param : parameters ) {
         bool valid = false;
-        for ( auto itr = c_ctx.curr_living_vars.rbegin(); itr != c_ctx.curr_living_vars.rend(); itr++ ) {
+        for ( auto itr = t_ctx.curr_living_vars.rbegin(); itr != t_ctx.curr_living_vars.rend(); itr++ ) {
             if ( std::find( itr->begin(), itr->end(), param ) != itr->end() ) {
                 // Variable is accessible
                 valid = true;
@@ -55,8 +56,9 @@ MirEntryId create_operation( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId func
     return c_ctx.functions[function].ops.size() - 1;
 }
 
-MirEntryId create_call( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId calling_function, AstNode &original_expr,
-                        SymbolId called_function, MirVarId result, std::vector<MirVarId> parameters ) {
+MirEntryId create_call( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, FunctionImplId calling_function,
+                        AstNode &original_expr, SymbolId called_function, MirVarId result,
+                        std::vector<MirVarId> parameters ) {
     FunctionImpl &caller = c_ctx.functions[calling_function];
     SymbolGraphNode &callee = c_ctx.symbol_graph[called_function];
     if ( parameters.size() != callee.identifier.parameters.size() )
@@ -64,7 +66,8 @@ MirEntryId create_call( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId calling_f
 
     // Create call operation
     auto op_id =
-        create_operation( c_ctx, w_ctx, calling_function, original_expr, MirEntry::Type::call, result, parameters );
+        create_operation( c_ctx, t_ctx, w_ctx, calling_function, original_expr, MirEntry::Type::call, result,
+                          parameters );
     auto &op = caller.ops[op_id];
     op.symbol = called_function;
     caller.vars[op.ret].type = MirVariable::Type::rvalue;
@@ -77,40 +80,40 @@ MirEntryId create_call( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId calling_f
         if ( callee.identifier.parameters[i].ref ) {
             // Reference parameter expected
             if ( caller.vars[parameters[i]].type == MirVariable::Type::rvalue ) {
-                drop_variable( c_ctx, w_ctx, calling_function, original_expr, parameters[i] );
+                drop_variable( c_ctx, t_ctx, w_ctx, calling_function, original_expr, parameters[i] );
             }
         } else {
             // Parameter moved
 
             // Drop referenced vars
             if ( caller.vars[parameters[i]].type == MirVariable::Type::l_ref ) {
-                remove_from_local_living_vars( c_ctx, w_ctx, calling_function, original_expr,
+                remove_from_local_living_vars( c_ctx, t_ctx, w_ctx, calling_function, original_expr,
                                                caller.vars[parameters[i]].ref );
             }
 
             // Remove from living variables
-            remove_from_local_living_vars( c_ctx, w_ctx, calling_function, original_expr, parameters[i] );
+            remove_from_local_living_vars( c_ctx, t_ctx, w_ctx, calling_function, original_expr, parameters[i] );
         }
     }
 
     return op_id;
 }
 
-MirVarId create_variable( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId function, AstNode *original_expr,
-                          const String &name ) {
+MirVarId create_variable( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, FunctionImplId function,
+                          AstNode *original_expr, const String &name ) {
     MirVarId id = c_ctx.functions[function].vars.size();
     c_ctx.functions[function].vars.emplace_back();
-    c_ctx.functions[function].vars[id].name = name;
+    c_ctx.functions[function].vars[id].name = InternedString( name );
     c_ctx.functions[function].vars[id].original_expr = original_expr;
-    c_ctx.curr_living_vars.back().push_back( id );
+    t_ctx.curr_living_vars.back().push_back( id );
     if ( !name.empty() ) {
-        c_ctx.curr_name_mapping.back()[name].push_back( id );
+        t_ctx.curr_name_mapping.back()[c_ctx.functions[function].vars[id].name].push_back( id );
     }
     return id;
 }
 
-void drop_variable( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId function, AstNode &original_expr,
-                    MirVarId variable ) {
+void drop_variable( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, FunctionImplId function,
+                    AstNode &original_expr, MirVarId variable ) {
     if ( variable == 0 )
         return;
 
@@ -124,17 +127,17 @@ void drop_variable( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId function, Ast
     }
 
     // Remove from living variables
-    remove_from_local_living_vars( c_ctx, w_ctx, function, original_expr, variable );
+    remove_from_local_living_vars( c_ctx, t_ctx, w_ctx, function, original_expr, variable );
 }
 
-void remove_from_local_living_vars( CrateCtx &c_ctx, Worker &w_ctx, FunctionImplId function, AstNode &original_expr,
-                                    MirVarId variable ) {
+void remove_from_local_living_vars( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, FunctionImplId function,
+                                    AstNode &original_expr, MirVarId variable ) {
     if ( variable == 0 )
         return;
 
     auto &var = c_ctx.functions[function].vars[variable];
 
-    for ( auto itr = c_ctx.curr_living_vars.rbegin(); itr != c_ctx.curr_living_vars.rend(); itr++ ) {
+    for ( auto itr = t_ctx.curr_living_vars.rbegin(); itr != t_ctx.curr_living_vars.rend(); itr++ ) {
         if ( auto var_itr = std::find( itr->begin(), itr->end(), variable ); var_itr != itr->end() ) {
             itr->erase( var_itr );
             break;
@@ -143,7 +146,7 @@ void remove_from_local_living_vars( CrateCtx &c_ctx, Worker &w_ctx, FunctionImpl
 
     // Remove from name mapping
     if ( !var.name.empty() ) {
-        for ( auto itr = c_ctx.curr_name_mapping.rbegin(); itr != c_ctx.curr_name_mapping.rend(); itr++ ) {
+        for ( auto itr = t_ctx.curr_name_mapping.rbegin(); itr != t_ctx.curr_name_mapping.rend(); itr++ ) {
             if ( auto var_itr = itr->find( var.name ); var_itr != itr->end() ) {
                 var_itr->second.pop_back();
                 if ( var_itr->second.empty() )
@@ -161,7 +164,7 @@ void remove_from_local_living_vars( CrateCtx &c_ctx, Worker &w_ctx, FunctionImpl
             std::make_pair( c_ctx.functions[function].vars[variable].name, &original_expr );
 }
 
-void analyse_function_signature( CrateCtx &c_ctx, Worker &w_ctx, SymbolId function ) {
+void analyse_function_signature( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, SymbolId function ) {
     auto &symbol = c_ctx.symbol_graph[function];
     // TODO find a better method to prevent multiple checks of the same function
     if ( function && symbol.identifier.eval_type.type == 0 && symbol.identifier.parameters.empty() ) {
@@ -196,7 +199,7 @@ void analyse_function_signature( CrateCtx &c_ctx, Worker &w_ctx, SymbolId functi
                     } else {
                         // Normal type
                         auto types = find_local_symbol_by_identifier_chain(
-                            c_ctx, w_ctx, type_symbol.get_symbol_chain( c_ctx, w_ctx ) );
+                            c_ctx, t_ctx, w_ctx, type_symbol.get_symbol_chain( c_ctx, t_ctx, w_ctx ) );
 
                         if ( !expect_exactly_one_symbol( c_ctx, w_ctx, types, type_symbol ) )
                             continue;
@@ -227,7 +230,7 @@ void analyse_function_signature( CrateCtx &c_ctx, Worker &w_ctx, SymbolId functi
                     new_parameter.type = c_ctx.symbol_graph[symbol.parent].value;
                 } else {
                     // Normal parameter
-                    auto symbol_chain = parameter_symbol->get_symbol_chain( c_ctx, w_ctx );
+                    auto symbol_chain = parameter_symbol->get_symbol_chain( c_ctx, t_ctx, w_ctx );
                     if ( !expect_unscoped_variable( c_ctx, w_ctx, *symbol_chain, *parameter_symbol ) )
                         continue;
                     new_parameter.name = symbol_chain->front().name;
@@ -253,7 +256,7 @@ void analyse_function_signature( CrateCtx &c_ctx, Worker &w_ctx, SymbolId functi
             } else {
                 // Normal return type
                 auto return_symbols = find_local_symbol_by_identifier_chain(
-                    c_ctx, w_ctx, return_symbol.get_symbol_chain( c_ctx, w_ctx ) );
+                    c_ctx, t_ctx, w_ctx, return_symbol.get_symbol_chain( c_ctx, t_ctx, w_ctx ) );
 
                 if ( !expect_exactly_one_symbol( c_ctx, w_ctx, return_symbols, return_symbol ) )
                     return;
@@ -268,6 +271,7 @@ void analyse_function_signature( CrateCtx &c_ctx, Worker &w_ctx, SymbolId functi
 
 // Creates a function from a FuncExpr specified by @param symbolId
 void generate_mir_function_impl( CrateCtx &c_ctx, Worker &w_ctx, SymbolId symbol_id ) {
+    PassTimer timer( w_ctx, "generate_mir_function_impl" );
     auto &symbol = c_ctx.symbol_graph[symbol_id];
     auto expr = *symbol.original_expr.front();
 
@@ -283,24 +287,24 @@ void generate_mir_function_impl( CrateCtx &c_ctx, Worker &w_ctx, SymbolId symbol
         return;
     }
 
-    c_ctx.curr_living_vars.clear();
-    c_ctx.curr_living_vars.emplace_back();
-    c_ctx.curr_name_mapping.clear();
-    c_ctx.curr_name_mapping.emplace_back();
+    // Every function body is a traversal of its own
+    TraversalCtx t_ctx;
+    t_ctx.curr_living_vars.emplace_back();
+    t_ctx.curr_name_mapping.emplace_back();
 
     // Create the function
     FunctionImplId func_id = c_ctx.functions.size();
     c_ctx.functions.emplace_back();
     FunctionImpl &function = c_ctx.functions.back();
-    create_variable( c_ctx, w_ctx, func_id, nullptr, "" ); // unit return value
-    analyse_function_signature( c_ctx, w_ctx, symbol_id );
+    create_variable( c_ctx, t_ctx, w_ctx, func_id, nullptr, "" ); // unit return value
+    analyse_function_signature( c_ctx, t_ctx, w_ctx, symbol_id );
     function.type = symbol.value;
 
     // Parse parameters
     auto paren_expr = expr.named[AstChild::parameters];
     for ( size_t i = 0; i < paren_expr.children.size(); i++ ) {
         auto &entry_symbol = symbol.identifier.parameters[i];
-        MirVarId id = create_variable( c_ctx, w_ctx, func_id, &paren_expr.children[i] );
+        MirVarId id = create_variable( c_ctx, t_ctx, w_ctx, func_id, &paren_expr.children[i] );
         function.params.push_back( id );
 
         function.vars[id].name = entry_symbol.name;
@@ -311,8 +315,8 @@ void generate_mir_function_impl( CrateCtx &c_ctx, Worker &w_ctx, SymbolId symbol
         else
             function.vars[id].type = MirVariable::Type::value;
 
-        c_ctx.curr_name_mapping.back()[function.vars[id].name].push_back( id );
-        c_ctx.curr_living_vars.back().push_back( id );
+        t_ctx.curr_name_mapping.back()[function.vars[id].name].push_back( id );
+        t_ctx.curr_living_vars.back().push_back( id );
     }
 
     // Self parameter
@@ -320,20 +324,21 @@ void generate_mir_function_impl( CrateCtx &c_ctx, Worker &w_ctx, SymbolId symbol
          ( paren_expr.children.front().type == ExprType::self ||
            ( paren_expr.children.front().type == ExprType::typed_op &&
              paren_expr.children.front().named[AstChild::left_expr].type == ExprType::self ) ) ) {
-        c_ctx.curr_self_var = 1; // per convention
-        c_ctx.curr_self_type = c_ctx.symbol_graph[symbol.parent].value;
+        t_ctx.curr_self_var = 1; // per convention
+        t_ctx.curr_self_type = c_ctx.symbol_graph[symbol.parent].value;
     } else {
-        c_ctx.curr_self_var = 0;
-        c_ctx.curr_self_type = 0;
+        t_ctx.curr_self_var = 0;
+        t_ctx.curr_self_type = 0;
     }
 
     // Parse body
-    function.ret = expr.children.front().parse_mir( c_ctx, w_ctx, func_id );
+    function.ret = expr.children.front().parse_mir( c_ctx, t_ctx, w_ctx, func_id );
 
     // Drop parameters
     for ( auto p_itr = function.params.rbegin(); p_itr != function.params.rend(); p_itr++ ) {
-        drop_variable( c_ctx, w_ctx, func_id, expr, *p_itr );
+        drop_variable( c_ctx, t_ctx, w_ctx, func_id, expr, *p_itr );
     }
+    timer.add_nodes( c_ctx.functions[func_id].ops.size() );
 }
 
 void get_mir( JobsBuilder &jb, UnitCtx &parent_ctx ) {
@@ -341,11 +346,16 @@ void get_mir( JobsBuilder &jb, UnitCtx &parent_ctx ) {
         auto c_ctx = w_ctx.do_query( get_ast )->jobs.back()->to<sptr<CrateCtx>>();
 
         // Prepare types in structs
-        for ( size_t i = 0; i < c_ctx->symbol_graph.size(); i++ ) {
-            if ( !c_ctx->symbol_graph[i].original_expr.empty() &&
-                 c_ctx->symbol_graph[i].original_expr.front()->type == ExprType::structure ) {
-                for ( auto &exprs : c_ctx->symbol_graph[i].original_expr ) {
-                    exprs->find_types( *c_ctx, w_ctx );
+        {
+            PassTimer timer( w_ctx, "find_types" );
+            TraversalCtx t_ctx;
+            for ( size_t i = 0; i < c_ctx->symbol_graph.size(); i++ ) {
+                if ( !c_ctx->symbol_graph[i].original_expr.empty() &&
+                     c_ctx->symbol_graph[i].original_expr.front()->type == ExprType::structure ) {
+                    for ( auto &exprs : c_ctx->symbol_graph[i].original_expr ) {
+                        exprs->find_types( *c_ctx, t_ctx, w_ctx );
+                        timer.add_nodes( 1 );
+                    }
                 }
             }
         }
@@ -377,7 +387,7 @@ void get_mir( JobsBuilder &jb, UnitCtx &parent_ctx ) {
                                             : fn.vars[id].type == MirVariable::Type::label
                                                   ? "b"
                                                   : fn.vars[id].type == MirVariable::Type::symbol ? "s" : "" );
-                return " " + fn.vars[id].name + "%" + type_str + to_string( id );
+                return " " + fn.vars[id].name.str() + "%" + type_str + to_string( id );
             };
 
             log( " fn " + to_string( i ) + " - " +
@@ -740,3 +740,66 @@ bool parse_mci_rule( sptr<PreludeConfig> &conf, sptr<SourceInput> &input, Worker
 }
 
 #undef CONSUME_COMMA
+
+std::ostream &operator<<( std::ostream &stream, const Operator &op ) {
+    // Strings are prefixed by their size to avoid ambiguities
+    stream << op.precedence << ',' << op.ltr << ',' << op.ambiguous << ',' << op.prec_class.first << ','
+           << op.prec_class.second << ',' << op.prec_bias << ',' << static_cast<int>( op.range ) << ','
+           << op.fn.size() << ':' << op.fn << '{';
+    for ( auto &entry : op.syntax )
+        stream << entry.first.size() << ':' << entry.first << entry.second.size() << ':' << entry.second;
+    return stream << '}';
+}
+
+std::ostream &operator<<( std::ostream &stream, const std::map<SyntaxType, std::vector<Operator>> &syntaxes ) {
+    stream << '{';
+    for ( auto &syntax : syntaxes ) {
+        stream << static_cast<int>( syntax.first ) << '{';
+        for ( auto &op : syntax.second )
+            stream << op;
+        stream << '}';
+    }
+    return stream << '}';
+}
+
+std::ostream &operator<<( std::ostream &stream, const PreludeConfig &conf ) {
+    auto write_str = [&stream]( const String &str ) { stream << str.size() << ':' << str; };
+
+    stream << conf.is_prelude << conf.is_prelude_library << conf.token_conf << conf.spaces_bind_identifiers << ','
+           << static_cast<int>( conf.function_case ) << ',' << static_cast<int>( conf.method_case ) << ','
+           << static_cast<int>( conf.variable_case ) << ',' << static_cast<int>( conf.module_case ) << ','
+           << static_cast<int>( conf.struct_case ) << ',' << static_cast<int>( conf.trait_case ) << '{';
+    for ( auto &prefix : conf.unused_prefix )
+        write_str( prefix );
+    stream << "}{";
+    for ( auto &rule : conf.string_rules ) {
+        write_str( rule.begin );
+        write_str( rule.end );
+        write_str( rule.prefix );
+        write_str( rule.rep_begin );
+        write_str( rule.rep_end );
+        stream << rule.escaped << rule.block << rule.utf8;
+    }
+    stream << '}' << conf.syntaxes;
+    for ( auto *str : { &conf.scope_access_operator, &conf.integer_trait, &conf.string_trait, &conf.tuple_trait,
+                        &conf.array_trait, &conf.iterator_trait, &conf.implication_trait, &conf.never_trait,
+                        &conf.drop_fn, &conf.equals_fn, &conf.itr_valid_fn, &conf.itr_get_fn, &conf.itr_next_fn } )
+        write_str( *str );
+    stream << '{';
+    for ( auto &type : conf.special_types ) {
+        write_str( type.first );
+        write_str( type.second );
+    }
+    stream << "}{";
+    for ( auto &type : conf.memblob_types ) {
+        write_str( type.first );
+        stream << static_cast<int>( type.second ) << ',';
+    }
+    stream << "}{";
+    for ( auto &literal : conf.literals ) {
+        write_str( literal.first );
+        write_str( literal.second.first );
+        stream << literal.second.second << ',';
+    }
+    return stream << '}';
+}
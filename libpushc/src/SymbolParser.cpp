@@ -14,19 +14,11 @@
 #include "libpushc/stdafx.h"
 #include "libpushc/SymbolParser.h"
 #include "libpushc/SymbolUtil.h"
+#include "libpushc/VisitorPasses.h"
 
 void parse_symbols( sptr<CrateCtx> c_ctx, JobsBuilder &jb, UnitCtx &parent_ctx ) {
     jb.add_job<void>( [c_ctx]( Worker &w_ctx ) {
-        AstNode dummy_root_parent = { ExprType::none };
-        bool successful = true;
-        if ( successful )
-            successful =
-                c_ctx->ast->visit( *c_ctx, w_ctx, VisitorPassType::BASIC_SEMANTIC_CHECK, dummy_root_parent, false );
-        if ( successful )
-            successful =
-                c_ctx->ast->visit( *c_ctx, w_ctx, VisitorPassType::FIRST_TRANSFORMATION, dummy_root_parent, false );
-        if ( successful )
-            successful =
-                c_ctx->ast->visit( *c_ctx, w_ctx, VisitorPassType::SYMBOL_DISCOVERY, dummy_root_parent, false );
+        run_visitor_passes_parallel<BasicSemanticCheckPass, FirstTransformationPass, SymbolDiscoveryPass>(
+            c_ctx, w_ctx );
     } );
 }
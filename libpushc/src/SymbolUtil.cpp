@@ -20,7 +20,7 @@ sptr<std::vector<SymbolIdentifier>> split_symbol_chain( const String &chained, S
     size_t prev_pos = pos;
     while ( pos != String::npos ) {
         pos = chained.find( separator, pos );
-        ret->push_back( SymbolIdentifier{ chained.slice( prev_pos, pos - prev_pos ) } );
+        ret->push_back( SymbolIdentifier{ InternedString( String( chained.slice( prev_pos, pos - prev_pos ) ) ) } );
         if ( pos != String::npos )
             pos += separator.size();
         prev_pos = pos;
@@ -57,7 +57,13 @@ bool symbol_identifier_matches( const SymbolIdentifier &pattern, const SymbolIde
 std::vector<SymbolId> find_sub_symbol_by_identifier( CrateCtx &c_ctx, Worker &w_ctx, const SymbolIdentifier &identifier,
                                                      SymbolId parent ) {
     std::vector<SymbolId> ret;
-    for ( auto &sub_id : c_ctx.symbol_graph[parent].sub_nodes ) {
+    // Only children with the same name can match
+    auto &by_name = c_ctx.symbol_graph[parent].sub_nodes_by_name;
+    auto candidates = by_name.find( identifier.name );
+    if ( candidates == by_name.end() )
+        return ret;
+
+    for ( auto &sub_id : candidates->second ) {
         if ( symbol_identifier_matches( identifier, c_ctx.symbol_graph[sub_id].identifier ) )
             ret.push_back( sub_id );
     }
@@ -93,9 +99,9 @@ std::vector<SymbolId> find_relative_symbol_by_identifier_chain( CrateCtx &c_ctx,
     }
 }
 
-std::vector<SymbolId> find_local_symbol_by_identifier_chain( CrateCtx &c_ctx, Worker &w_ctx,
+std::vector<SymbolId> find_local_symbol_by_identifier_chain( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx,
                                                              sptr<std::vector<SymbolIdentifier>> identifier_chain ) {
-    return find_relative_symbol_by_identifier_chain( c_ctx, w_ctx, identifier_chain, c_ctx.current_scope );
+    return find_relative_symbol_by_identifier_chain( c_ctx, w_ctx, identifier_chain, t_ctx.current_scope );
 }
 
 std::vector<size_t> find_member_symbol_by_identifier( CrateCtx &c_ctx, Worker &w_ctx,
@@ -120,11 +126,13 @@ std::vector<SymbolId> find_template_instantiations( CrateCtx &c_ctx, Worker &w_c
     auto &identifier = c_ctx.symbol_graph[template_symbol].identifier;
     auto &parent = c_ctx.symbol_graph[c_ctx.symbol_graph[template_symbol].parent];
     std::vector<SymbolId> ret;
+    auto candidates = parent.sub_nodes_by_name.find( identifier.name );
+    if ( candidates == parent.sub_nodes_by_name.end() )
+        return ret;
 
-    for ( auto &sub : parent.sub_nodes ) {
+    for ( auto &sub : candidates->second ) {
         // Don't check template_values
-        if ( c_ctx.symbol_graph[sub].identifier.name == identifier.name &&
-             c_ctx.symbol_graph[sub].identifier.eval_type == identifier.eval_type &&
+        if ( c_ctx.symbol_graph[sub].identifier.eval_type == identifier.eval_type &&
              c_ctx.symbol_graph[sub].identifier.parameters == identifier.parameters )
             ret.push_back( sub );
     }
@@ -162,7 +170,7 @@ String get_local_symbol_name( CrateCtx &c_ctx, Worker &w_ctx, SymbolId symbol )
                to_string( ident.eval_type.type );
         for ( size_t i = 0; i < ident.parameters.size(); i++ ) {
             ret += "," + String( ident.parameters[i].mut ? "mut " : "" ) + ( ident.parameters[i].ref ? "&" : "" ) +
-                   ident.parameters[i].name + ":" + to_string( ident.parameters[i].type );
+                   ident.parameters[i].name.str() + ":" + to_string( ident.parameters[i].type );
         }
         ret += "]";
     }
@@ -199,13 +207,13 @@ String merge_symbol_chain( const std::vector<SymbolIdentifier> &symbol_chain ) {
     } else {
         String ret = symbol_chain.front().name;
         for ( auto symbol = symbol_chain.begin() + 1; symbol != symbol_chain.end(); symbol++ ) {
-            ret += "::" + symbol->name;
+            ret += "::" + symbol->name.str();
         }
         return ret;
     }
 }
 
-bool alias_name_chain( CrateCtx &c_ctx, Worker &w_ctx, std::vector<SymbolIdentifier> &symbol_chain,
+bool alias_name_chain( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, std::vector<SymbolIdentifier> &symbol_chain,
                        const AstNode &symbol ) {
     // Tests if a given SymbolSubstitution matches the symbol_chain
     auto test = [&c_ctx, &symbol_chain]( SymbolSubstitution &ssub ) {
@@ -218,7 +226,7 @@ bool alias_name_chain( CrateCtx &c_ctx, Worker &w_ctx, std::vector<SymbolIdentif
         return true;
     };
 
-    for ( auto scope_itr = c_ctx.current_substitutions.rbegin(); scope_itr != c_ctx.current_substitutions.rend();
+    for ( auto scope_itr = t_ctx.current_substitutions.rbegin(); scope_itr != t_ctx.current_substitutions.rend();
           scope_itr++ ) {
         auto first = std::find_if( scope_itr->begin(), scope_itr->end(), test );
         if ( first != scope_itr->end() ) {
@@ -241,32 +249,41 @@ bool alias_name_chain( CrateCtx &c_ctx, Worker &w_ctx, std::vector<SymbolIdentif
 }
 
 SymbolId create_new_global_symbol( CrateCtx &c_ctx, Worker &w_ctx, const String &name ) {
-    if ( !find_sub_symbol_by_identifier( c_ctx, w_ctx, SymbolIdentifier{ name }, ROOT_SYMBOL ).empty() ) {
+    if ( !find_sub_symbol_by_identifier( c_ctx, w_ctx, SymbolIdentifier{ InternedString( name ) }, ROOT_SYMBOL )
+              .empty() ) {
         LOG_ERR( "Attempted to create an existing global symbol '" + name + "'" );
     }
     SymbolId sym_id = c_ctx.symbol_graph.size();
     c_ctx.symbol_graph.emplace_back();
-    c_ctx.symbol_graph[sym_id].identifier.name = name;
+    c_ctx.symbol_graph[sym_id].identifier.name = InternedString( name );
     return sym_id;
 }
 
-SymbolId create_new_relative_symbol( CrateCtx &c_ctx, Worker &w_ctx, const SymbolIdentifier &identifier,
-                                     SymbolId parent_symbol ) {
-    if ( !identifier.name.empty() &&
-         !find_sub_symbol_by_identifier( c_ctx, w_ctx, identifier, parent_symbol ).empty() ) {
-        LOG_ERR( "Attempted to create an existing non-anonymous relative symbol '" + identifier.name + "' to parent '" +
-                 to_string( parent_symbol ) + "'" );
-    }
+// Appends a new symbol to the graph without checking for existing symbols
+static SymbolId add_sub_symbol( CrateCtx &c_ctx, const SymbolIdentifier &identifier, SymbolId parent_symbol ) {
     SymbolId sym_id = c_ctx.symbol_graph.size();
     c_ctx.symbol_graph.emplace_back();
     c_ctx.symbol_graph[sym_id].parent = parent_symbol;
     c_ctx.symbol_graph[parent_symbol].sub_nodes.push_back( sym_id );
+    c_ctx.symbol_graph[parent_symbol].sub_nodes_by_name[identifier.name].push_back( sym_id );
     c_ctx.symbol_graph[sym_id].identifier = identifier;
     return sym_id;
 }
 
-SymbolId create_new_local_symbol( CrateCtx &c_ctx, Worker &w_ctx, const SymbolIdentifier &identifier ) {
-    return create_new_relative_symbol( c_ctx, w_ctx, identifier, c_ctx.current_scope );
+SymbolId create_new_relative_symbol( CrateCtx &c_ctx, Worker &w_ctx, const SymbolIdentifier &identifier,
+                                     SymbolId parent_symbol ) {
+    if ( !identifier.name.empty() &&
+         !find_sub_symbol_by_identifier( c_ctx, w_ctx, identifier, parent_symbol ).empty() ) {
+        LOG_ERR( "Attempted to create an existing non-anonymous relative symbol '" + identifier.name.str() +
+                 "' to parent '" +
+                 to_string( parent_symbol ) + "'" );
+    }
+    return add_sub_symbol( c_ctx, identifier, parent_symbol );
+}
+
+SymbolId create_new_local_symbol( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx,
+                                  const SymbolIdentifier &identifier ) {
+    return create_new_relative_symbol( c_ctx, w_ctx, identifier, t_ctx.current_scope );
 }
 
 SymbolId create_new_global_symbol_from_name_chain( CrateCtx &c_ctx, Worker &w_ctx,
@@ -309,11 +326,11 @@ SymbolId create_new_relative_symbol_from_name_chain( CrateCtx &c_ctx, Worker &w_
     return curr_symbol;
 }
 
-SymbolId create_new_local_symbol_from_name_chain( CrateCtx &c_ctx, Worker &w_ctx,
+SymbolId create_new_local_symbol_from_name_chain( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx,
                                                   const sptr<std::vector<SymbolIdentifier>> symbol_chain,
                                                   const AstNode &symbol ) {
-    alias_name_chain( c_ctx, w_ctx, *symbol_chain, symbol );
-    return create_new_relative_symbol_from_name_chain( c_ctx, w_ctx, symbol_chain, c_ctx.current_scope );
+    alias_name_chain( c_ctx, t_ctx, w_ctx, *symbol_chain, symbol );
+    return create_new_relative_symbol_from_name_chain( c_ctx, w_ctx, symbol_chain, t_ctx.current_scope );
 }
 
 SymbolGraphNode &create_new_member_symbol( CrateCtx &c_ctx, Worker &w_ctx, const SymbolIdentifier &symbol_identifier,
@@ -341,58 +358,70 @@ TypeId create_new_type( CrateCtx &c_ctx, Worker &w_ctx, SymbolId from_symbol ) {
     return type_id;
 }
 
+size_t hash_template_values( const std::vector<std::pair<TypeId, ConstValue>> &template_values ) {
+    size_t hash = template_values.size();
+    for ( auto &tv : template_values ) {
+        std::hash_combine( hash, tv.first );
+        std::hash_combine( hash, tv.second.get_raw() );
+    }
+    return hash;
+}
+
 SymbolId instantiate_template( CrateCtx &c_ctx, Worker &w_ctx, SymbolId from_template,
                                std::vector<std::pair<TypeId, ConstValue>> &template_values ) {
-    // Search for an existing template instantiation
-    auto existing_tuple_types = find_template_instantiations( c_ctx, w_ctx, c_ctx.type_table[c_ctx.tuple_type].symbol );
-    if ( existing_tuple_types.empty() ) {
-        // Its not a template (error is already generated by find_template_instantiations). Normally the template
-        // itself is included in the list
+    // Check if it's a template
+    if ( c_ctx.symbol_graph[from_template].identifier.template_values.empty() ) {
+        LOG_ERR( "Attempted to instantiate a non-template" );
         return 0;
     }
-    auto first = std::find_if( existing_tuple_types.begin(), existing_tuple_types.end(), [&]( SymbolId s ) {
-        return c_ctx.symbol_graph[s].identifier.template_values == template_values;
-    } );
+    if ( c_ctx.symbol_graph[from_template].identifier.template_values == template_values )
+        return from_template;
+
+    // Search for an existing template instantiation (the list only contains hash collisions)
+    auto &instances = c_ctx.template_instances[from_template][hash_template_values( template_values )];
+    for ( auto &instance : instances ) {
+        if ( c_ctx.symbol_graph[instance].identifier.template_values == template_values )
+            return instance; // Template already instantiated
+    }
 
-    if ( first != existing_tuple_types.end() ) {
-        // Template already instantiated
-        return *first;
-    } else {
-        // Create a new template instance
-        // TODO maybe extract this into a clone-function
-        auto identifier = c_ctx.symbol_graph[from_template].identifier;
-        identifier.template_values = template_values;
-        auto &parent = c_ctx.symbol_graph[from_template].parent;
-        auto new_symbol = create_new_relative_symbol( c_ctx, w_ctx, identifier, parent );
-        auto new_type = create_new_type( c_ctx, w_ctx, new_symbol );
-
-        // Copy symbol information
-        auto &symbol = c_ctx.symbol_graph[new_symbol];
-        symbol.identifier = identifier;
-        symbol.original_expr = c_ctx.symbol_graph[from_template].original_expr;
-        symbol.pub = c_ctx.symbol_graph[from_template].pub;
-        symbol.sub_nodes = c_ctx.symbol_graph[from_template].sub_nodes; // TODO instantiate template methods aswell?
-        symbol.type = c_ctx.symbol_graph[from_template].type;
-
-        // Copy type information
-        c_ctx.type_table[new_type] = c_ctx.type_table[from_template];
+    // Create a new template instance. The duplicate check of create_new_relative_symbol() would ignore the template
+    // values, so the symbol is added directly
+    // TODO maybe extract this into a clone-function
+    auto identifier = c_ctx.symbol_graph[from_template].identifier;
+    identifier.template_values = template_values;
+    auto new_symbol = add_sub_symbol( c_ctx, identifier, c_ctx.symbol_graph[from_template].parent );
+    auto new_type = create_new_type( c_ctx, w_ctx, new_symbol );
+    instances.push_back( new_symbol );
+
+    // Copy symbol information
+    auto &symbol = c_ctx.symbol_graph[new_symbol];
+    auto &templ = c_ctx.symbol_graph[from_template];
+    symbol.original_expr = templ.original_expr;
+    symbol.pub = templ.pub;
+    symbol.sub_nodes = templ.sub_nodes; // TODO instantiate template methods aswell?
+    symbol.sub_nodes_by_name = templ.sub_nodes_by_name;
+    symbol.type = templ.type;
+
+    // Copy type information
+    if ( templ.value != 0 ) {
+        c_ctx.type_table[new_type] = c_ctx.type_table[templ.value];
         c_ctx.type_table[new_type].symbol = new_symbol; // fix symbol
-        // TODO handle subtype & supertype relations
-
-        return new_symbol;
     }
+    // TODO handle subtype & supertype relations
+
+    return new_symbol;
 }
 
-void switch_scope_to_symbol( CrateCtx &c_ctx, Worker &w_ctx, SymbolId new_scope ) {
-    c_ctx.current_scope = new_scope;
+void switch_scope_to_symbol( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx, SymbolId new_scope ) {
+    t_ctx.current_scope = new_scope;
 }
 
-void pop_scope( CrateCtx &c_ctx, Worker &w_ctx ) {
-    if ( c_ctx.symbol_graph[c_ctx.current_scope].parent == 0 ) {
+void pop_scope( CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx ) {
+    if ( c_ctx.symbol_graph[t_ctx.current_scope].parent == 0 ) {
         LOG_ERR( "Attempted to switch to the parent scope of the root scope" );
         return;
     }
-    switch_scope_to_symbol( c_ctx, w_ctx, c_ctx.symbol_graph[c_ctx.current_scope].parent );
+    switch_scope_to_symbol( c_ctx, t_ctx, w_ctx, c_ctx.symbol_graph[t_ctx.current_scope].parent );
 }
 
 bool expect_exactly_one_symbol( CrateCtx &c_ctx, Worker &w_ctx, std::vector<SymbolId> &container,
@@ -0,0 +1,180 @@
+// Copyright 2020 Erik Götzfried
+// Licensed under the Apache License, Version 2.0( the "License" );
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "libpushc/stdafx.h"
+#include "libpush/bench/Bench.h"
+#include "libpush/input/BufferedInput.h"
+#include "libpushc/AstParser.h"
+#include "libpushc/Prelude.h"
+#include "libpushc/SymbolParser.h"
+#include "libpushc/VisitorPasses.h"
+
+// A generated parser input. Workloads of one axis are sorted by their scaled property
+struct ParserWorkload {
+    String axis; // scaled property
+    size_t scale = 0; // value of the scaled property
+    String source;
+    size_t extra_rules = 0; // amount of synthetic syntax rules which are added to the prelude
+};
+
+// Creates a function with some simple statements. Each function is on its own line, because expressions over multiple
+// lines are not supported by the message system
+static String generate_function( size_t idx, const std::function<String( size_t )> &statement, size_t count ) {
+    String line = "fn_" + to_string( idx ) + " {";
+    for ( size_t i = 0; i < count; i++ )
+        line += " " + statement( idx * count + i );
+    return line + " }\n";
+}
+
+// Returns a binary expression with @param depth nested terms
+static String generate_nested_expr( size_t depth ) {
+    String expr = "a";
+    for ( size_t i = 0; i < depth; i++ )
+        expr = "(" + expr + ( i % 2 ? " * " : " + " ) + "v_" + to_string( i ) + ")";
+    return expr;
+}
+
+// Returns an expression which chains @param length ambiguous operators. Each of them forks the parse paths, so the
+// chains are kept short
+static String generate_ambiguous_chain( size_t length ) {
+    String expr = "a";
+    for ( size_t i = 0; i < length; i++ )
+        expr += " < b_" + to_string( i );
+    return expr;
+}
+
+// Returns the workloads of all axes
+static std::vector<ParserWorkload> generate_workloads( size_t size ) {
+    auto simple_statement = []( size_t i ) {
+        return "let v_" + to_string( i ) + " = a + b_" + to_string( i % 13 ) + " * c;";
+    };
+
+    std::vector<ParserWorkload> workloads;
+    for ( size_t shift = 5; shift > 1; shift-- ) {
+        String source = generate_source( size >> shift, [&]( size_t i ) {
+            return generate_function( i, simple_statement, 16 );
+        } );
+        size_t statements = std::count( source.begin(), source.end(), ';' );
+        workloads.push_back( ParserWorkload{ "statements", statements, source } );
+    }
+    for ( size_t depth : { 8, 16, 32, 64 } ) {
+        auto nested_statement = [&]( size_t i ) {
+            return "let v_" + to_string( i ) + " = " + generate_nested_expr( depth ) + ";";
+        };
+        String source;
+        for ( size_t i = 0; i < 32; i++ )
+            source += generate_function( i, nested_statement, 1 );
+        workloads.push_back( ParserWorkload{ "nesting", depth, source } );
+    }
+    for ( size_t length : { 1, 2, 3 } ) {
+        auto chain_statement = [&]( size_t i ) {
+            return "let v_" + to_string( i ) + " = " + generate_ambiguous_chain( length ) + ";";
+        };
+        String source;
+        for ( size_t i = 0; i < 4; i++ )
+            source += generate_function( i, chain_statement, 2 );
+        workloads.push_back( ParserWorkload{ "ambiguity", length, source } );
+    }
+    String rules_source = workloads[1].source;
+    for ( size_t rules : { 0, 128, 512 } ) {
+        workloads.push_back( ParserWorkload{ "rules", rules, rules_source, rules } );
+    }
+    return workloads;
+}
+
+// Adds synthetic binary operators which never match, but have to be checked for every operand
+static void add_synthetic_rules( PreludeConfig &config, size_t count ) {
+    for ( size_t i = 0; i < count; i++ ) {
+        Operator op;
+        op.precedence = 16;
+        op.syntax = { { "expr", "left" }, { "op_bench_" + to_string( i ), "op" }, { "expr", "right" } };
+        op.fn = "bench_" + to_string( i );
+        config.syntaxes[SyntaxType::op].push_back( op );
+    }
+}
+
+// Runs all parser benchmark cases. Must be executed inside of a job
+static void parser_benchmarks( sptr<const BenchOptions> options, sptr<const PreludeConfig> base_config,
+                               JobsBuilder &jb, UnitCtx &parent_ctx ) {
+    jb.add_job<void>( [options, base_config]( Worker &w_ctx ) {
+        auto file = make_shared<String>( "bench.push" );
+        std::map<std::pair<String, String>, std::vector<std::pair<size_t, BenchResult>>>
+            series; // by axis and input
+
+        for ( auto &workload : generate_workloads( options->source_size ) ) {
+            auto config = *base_config;
+            add_synthetic_rules( config, workload.extra_rules );
+            w_ctx.unit_ctx()->prelude_conf = config;
+            auto base_ctx = make_shared<CrateCtx>();
+            load_base_types( *base_ctx, w_ctx, w_ctx.unit_ctx()->prelude_conf );
+            load_syntax_rules( w_ctx, *base_ctx );
+
+            // The source is tokenized once, so that only the parser is measured
+            auto input = make_shared<BufferedInput>( file, w_ctx.shared_from_this(),
+                                                     make_shared<const String>( workload.source ) );
+            input->configure( config.token_conf );
+
+            // Synthetic rules are scaled together with the rules of the prelude
+            size_t scale = workload.scale;
+            if ( workload.axis == "rules" )
+                scale = base_ctx->syntax_table->rules.size();
+
+            BenchResult result;
+            result.suite = "parser";
+            result.config = "push";
+            result.source = workload.axis + "_" + to_string( workload.scale );
+            result.bytes = workload.source.size();
+
+            auto run_case = [&]( const String &input_name, bool with_symbols ) {
+                String name = result.suite + "/" + result.config + "/" + result.source + "/" + input_name;
+                if ( !options->filter.empty() && name.find( options->filter ) == String::npos )
+                    return;
+                result.input = input_name;
+                result.seconds = measure_fastest(
+                    *options,
+                    [&]() {
+                        auto c_ctx = make_shared<CrateCtx>(); // base types are cheap compared to parsing
+                        load_base_types( *c_ctx, w_ctx, w_ctx.unit_ctx()->prelude_conf );
+                        c_ctx->syntax_table = base_ctx->syntax_table;
+                        c_ctx->ast = make_shared<AstNode>();
+                        input->reset( 0 );
+                        sptr<SourceInput> source_input = input;
+                        *c_ctx->ast = parse_scope( source_input, w_ctx, *c_ctx, Token::Type::eof, nullptr );
+                        if ( with_symbols )
+                            w_ctx.do_query( parse_symbols, c_ctx );
+                        result.items = count_ast_nodes( *c_ctx->ast );
+                    },
+                    &result );
+                report( *options, result );
+                series[std::make_pair( workload.axis, input_name )].push_back( std::make_pair( scale, result ) );
+            };
+
+            run_case( "parse_scope", false );
+            run_case( "parse_symbols", true );
+        }
+
+        for ( auto &entry : series )
+            check_scaling( *options, entry.second );
+    } );
+}
+
+void run_benchmarks( const BenchOptions &options ) {
+    auto g_ctx = make_shared<GlobalCtx>();
+    auto w_ctx = g_ctx->setup( 1, 0 );
+
+    auto config = make_shared<PreludeConfig>(
+        w_ctx->do_query( load_prelude, make_shared<String>( "push" ) )->jobs.back()->to<PreludeConfig>() );
+    w_ctx->do_query( parser_benchmarks, sptr<const BenchOptions>( make_shared<BenchOptions>( options ) ),
+                     sptr<const PreludeConfig>( config ) );
+    g_ctx->wait_finished();
+}
@@ -14,10 +14,12 @@
 #include <regex>
 #include "libpushc/tests/stdafx.h"
 #include "libpushc/AstParser.h"
+#include "libpushc/AstCache.h"
 #include "libpushc/Prelude.h"
 #include "libpushc/Expression.h"
 #include "libpushc/Util.h"
-#include "libpushc/tests/StringInput.h"
+#include "libpush/input/StringInput.h"
+#include "libpush/input/SourceStore.h"
 
 static void test_parser( const String &data, sptr<PreludeConfig> config, JobsBuilder &jb, UnitCtx &parent_ctx ) {
     jb.add_job<AstNode>( [data, config]( Worker &w_ctx ) {
@@ -177,3 +179,199 @@ TEST_CASE( "Ast parser", "[syntax_parser]" ) {
         CHECK( str == d.second );
     }
 }
+
+TEST_CASE( "Original list references", "[syntax_parser]" ) {
+    auto g_ctx = make_shared<GlobalCtx>();
+    auto w_ctx = g_ctx->setup( 1 );
+
+    auto config = make_shared<PreludeConfig>();
+    *config = w_ctx->do_query( load_prelude, make_shared<String>( "push" ) )->jobs.back()->to<PreludeConfig>();
+    g_ctx->set_pref<StringSV>( PrefType::input_source, "debug" );
+
+    // Nested operators must not store their operands a second time
+    auto ast = w_ctx->do_query( test_parser, String( "a + b * c + d;" ), config )->jobs.back()->to<AstNode>();
+    REQUIRE( ast.children.size() == 1 );
+    REQUIRE( ast.children.front().children.size() == 1 );
+    auto &op = ast.children.front().children.front();
+    REQUIRE( op.type == ExprType::op );
+    REQUIRE( op.get_payload() );
+    REQUIRE( op.get_payload()->original_list.size() == 3 );
+    CHECK( op.get_payload()->original_stored.size() == 1 ); // only the operator token
+    CHECK( &op.original_at( 0 ) == &op.named.at( AstChild::left_expr ) );
+    CHECK( &op.original_at( 2 ) == &op.named.at( AstChild::right_expr ) );
+    CHECK( op.original_at( 1 ).token.str() == "+" );
+
+    auto &left = op.named.at( AstChild::left_expr );
+    REQUIRE( left.type == ExprType::op );
+    REQUIRE( left.get_payload() );
+    CHECK( left.get_payload()->original_stored.size() == 1 );
+    CHECK( left.original_at( 2 ).type == ExprType::op );
+}
+
+static void test_syntax_rules( sptr<PreludeConfig> config, JobsBuilder &jb, UnitCtx &parent_ctx ) {
+    jb.add_job<sptr<CrateCtx>>( [config]( Worker &w_ctx ) {
+        w_ctx.unit_ctx()->prelude_conf = *config;
+
+        auto c_ctx = make_shared<CrateCtx>();
+        load_base_types( *c_ctx, w_ctx, w_ctx.unit_ctx()->prelude_conf );
+        load_syntax_rules( w_ctx, *c_ctx );
+        return c_ctx;
+    } );
+}
+
+TEST_CASE( "Syntax rule index", "[syntax_parser]" ) {
+    auto g_ctx = make_shared<GlobalCtx>();
+    auto w_ctx = g_ctx->setup( 1 );
+
+    auto config = make_shared<PreludeConfig>();
+    *config = w_ctx->do_query( load_prelude, make_shared<String>( "push" ) )->jobs.back()->to<PreludeConfig>();
+    auto c_ctx = w_ctx->do_query( test_syntax_rules, config )->jobs.back()->to<sptr<CrateCtx>>();
+    auto &rules = c_ctx->syntax_table->rules;
+    auto &index = c_ctx->syntax_table->index;
+    REQUIRE( index.rule_count == rules.size() );
+
+    // Every rule whose last pattern matches the newest expression must be a candidate
+    std::vector<AstNode> samples;
+    for ( auto &rule : rules ) {
+        if ( !rule.expr_list.empty() )
+            samples.push_back( rule.expr_list.back() );
+    }
+    auto symbol = AstNode{ ExprType::atomic_symbol };
+    symbol.generate_new_props();
+    samples.push_back( symbol );
+
+    std::vector<size_t> candidates;
+    for ( auto &sample : samples ) {
+        index.collect_candidates( rules, &sample, true, candidates );
+        CHECK( std::is_sorted( candidates.begin(), candidates.end() ) );
+        CHECK( candidates.size() < rules.size() );
+        for ( size_t i = 0; i < rules.size(); i++ ) {
+            if ( !rules[i].expr_list.empty() && sample.matches( rules[i].expr_list.back() ) )
+                CHECK( std::find( candidates.begin(), candidates.end(), i ) != candidates.end() );
+        }
+    }
+}
+
+TEST_CASE( "Shared syntax tables", "[syntax_parser]" ) {
+    auto g_ctx = make_shared<GlobalCtx>();
+    auto w_ctx = g_ctx->setup( 1 );
+
+    auto config = make_shared<PreludeConfig>();
+    *config = w_ctx->do_query( load_prelude, make_shared<String>( "push" ) )->jobs.back()->to<PreludeConfig>();
+    auto get_table = [&]( const std::map<SyntaxType, std::vector<Operator>> &syntaxes ) {
+        return w_ctx->do_query( compile_syntax_table, syntaxes )->jobs.back()->to<sptr<const SyntaxTable>>();
+    };
+
+    // Crates with the same prelude syntaxes share their table
+    auto table = w_ctx->do_query( test_syntax_rules, config )->jobs.back()->to<sptr<CrateCtx>>()->syntax_table;
+    REQUIRE( table );
+    CHECK( table == get_table( config->syntaxes ) );
+    CHECK( table->rules.size() == table->index.rule_count );
+
+    // A changed syntax results in another table
+    auto changed_syntaxes = config->syntaxes;
+    REQUIRE( !changed_syntaxes[SyntaxType::op].empty() );
+    changed_syntaxes[SyntaxType::op].front().precedence++;
+    auto changed_table = get_table( changed_syntaxes );
+    CHECK( changed_table != table );
+    CHECK( changed_table->rules.size() == table->rules.size() );
+}
+
+TEST_CASE( "Binary AST cache", "[syntax_parser]" ) {
+    auto g_ctx = make_shared<GlobalCtx>();
+    auto w_ctx = g_ctx->setup( 1 );
+
+    auto config = make_shared<PreludeConfig>();
+    *config = w_ctx->do_query( load_prelude, make_shared<String>( "push" ) )->jobs.back()->to<PreludeConfig>();
+
+    String data = "fn1 { let a = 1 + 2; } let x = \"str\"; fn<A, B> { a+fn(a+b, c); } for i in 1..3 { g[i]; }";
+    auto ast = w_ctx->do_query( test_parser, data, config )->jobs.back()->to<AstNode>();
+    auto file = make_shared<String>( "test" );
+
+    // Round trip
+    std::vector<u8> blob;
+    REQUIRE( serialize_ast( ast, *file, blob ) );
+    AstNode restored;
+    REQUIRE( deserialize_ast( blob, file, restored ) );
+    CHECK( restored.get_debug_repr() == ast.get_debug_repr() );
+    REQUIRE( restored.children.size() == ast.children.size() );
+    CHECK( restored.children.front().pos_info.file == SourceStore::get_global()->get_file_id( file ) );
+    CHECK( restored.children.front().pos_info.offset == ast.children.front().pos_info.offset );
+    CHECK( restored.children.front().pos_info.column == ast.children.front().pos_info.column );
+    CHECK( restored.children.front().props == ast.children.front().props );
+    std::vector<u8> blob2;
+    CHECK( serialize_ast( restored, *file, blob2 ) );
+    CHECK( blob2 == blob );
+
+    // Positions in other files can't be stored and malformed blobs are detected
+    CHECK( !serialize_ast( ast, "other", blob2 ) );
+    blob.pop_back();
+    CHECK( !deserialize_ast( blob, file, restored ) );
+
+    // Entries are keyed by source and prelude
+    auto key = get_ast_cache_key( data, *config );
+    CHECK( key != get_ast_cache_key( data + " ", *config ) );
+    auto other_config = *config;
+    other_config.syntaxes[SyntaxType::op].front().precedence++;
+    CHECK( key != get_ast_cache_key( data, other_config ) );
+
+    String cache_dir = ( fs::temp_directory_path() / "push_ast_cache_test" ).string();
+    fs::remove_all( cache_dir );
+    CHECK( !load_cached_ast( cache_dir, key, file, restored ) );
+    REQUIRE( store_cached_ast( cache_dir, key, ast, *file ) );
+    AstNode loaded;
+    REQUIRE( load_cached_ast( cache_dir, key, file, loaded ) );
+    CHECK( loaded.get_debug_repr() == ast.get_debug_repr() );
+    CHECK( !load_cached_ast( cache_dir, key + 1, file, loaded ) );
+    fs::remove_all( cache_dir );
+}
+
+static void test_parallel_parser( const String &data, sptr<PreludeConfig> config, JobsBuilder &jb,
+                                  UnitCtx &parent_ctx ) {
+    // Returns the sequential and the parallel AST, the amount of items and the amount of messages
+    jb.add_job<std::tuple<String, String, size_t, size_t>>( [data, config]( Worker &w_ctx ) {
+        w_ctx.unit_ctx()->prelude_conf = *config;
+        auto c_ctx = make_shared<CrateCtx>();
+        load_base_types( *c_ctx, w_ctx, w_ctx.unit_ctx()->prelude_conf );
+        load_syntax_rules( w_ctx, *c_ctx );
+
+        auto source = make_shared<const String>( data );
+        sptr<SourceInput> input = make_shared<BufferedInput>( make_shared<String>( "test" ),
+                                                              w_ctx.shared_from_this(), source );
+        input->configure( config->token_conf );
+        String sequential = parse_scope( input, w_ctx, *c_ctx, Token::Type::eof, nullptr ).get_debug_repr();
+
+        auto buffered_input = make_shared<BufferedInput>( make_shared<String>( "test" ), w_ctx.shared_from_this(),
+                                                          source );
+        buffered_input->configure( config->token_conf );
+        auto boundaries = find_top_level_items( *buffered_input->get_buffer(), 0 );
+        size_t message_count = 0;
+        auto items = w_ctx.do_query( parse_top_level_items, buffered_input, c_ctx, boundaries );
+        auto block = AstNode{ ExprType::decl_scope };
+        block.generate_new_props();
+        for ( auto &job : items->free_jobs() ) {
+            auto item = job->to<std::pair<std::vector<AstNode>, std::vector<DeferredMessage>>>();
+            message_count += item.second.size();
+            block.children.insert( block.children.end(), item.first.begin(), item.first.end() );
+        }
+        return std::make_tuple( sequential, block.get_debug_repr(), boundaries.size() - 1, message_count );
+    } );
+}
+
+TEST_CASE( "Parallel top-level parsing", "[syntax_parser]" ) {
+    auto g_ctx = make_shared<GlobalCtx>();
+    auto w_ctx = g_ctx->setup( 4 );
+
+    auto config = make_shared<PreludeConfig>();
+    *config = w_ctx->do_query( load_prelude, make_shared<String>( "push" ) )->jobs.back()->to<PreludeConfig>();
+
+    String data = "fn1 { let a = 1 + 2; } fn2(a:int) -> int { a * 2 } let x = 5; struct A { v:int } impl A { } "
+                  "fn3 { if true { let b = 3; } else { let b = 4; } } f(g<a>(c)); fn<A, B> { a+fn(a+b, c); } "
+                  "do { f(c, d); } until true; g { /* comment; } */ }";
+    auto result = w_ctx->do_query( test_parallel_parser, data, config )
+                      ->jobs.back()
+                      ->to<std::tuple<String, String, size_t, size_t>>();
+    CHECK( std::get<0>( result ) == std::get<1>( result ) );
+    CHECK( std::get<2>( result ) == 6 );
+    CHECK( std::get<3>( result ) == 0 );
+}
@@ -17,7 +17,10 @@
 #include "libpushc/Prelude.h"
 #include "libpushc/Expression.h"
 #include "libpushc/Util.h"
-#include "libpushc/tests/StringInput.h"
+#include "libpushc/SymbolParser.h"
+#include "libpushc/SymbolUtil.h"
+#include "libpushc/VisitorPasses.h"
+#include "libpush/input/StringInput.h"
 
 static void test_parser( const String &data, sptr<PreludeConfig> config, sptr<std::vector<VisitorPassType>> passes,
                          JobsBuilder &jb, UnitCtx &parent_ctx ) {
@@ -282,7 +285,7 @@ TEST_CASE( "Symbol discovery", "[semantic_parser]" ) {
 
     // Check
     auto graph_start = std::find_if( c_ctx->symbol_graph.begin(), c_ctx->symbol_graph.end(),
-                                     []( const SymbolGraphNode &node ) { return node.identifier.name == "A"; } );
+                                     []( const SymbolGraphNode &node ) { return node.identifier.name.str() == "A"; } );
     u32 graph_start_idx = graph_start - c_ctx->symbol_graph.begin();
     auto type_start =
         std::find_if( c_ctx->type_table.begin(), c_ctx->type_table.end(),
@@ -291,51 +294,40 @@ TEST_CASE( "Symbol discovery", "[semantic_parser]" ) {
     REQUIRE( c_ctx->symbol_graph.end() - graph_start == 25 ); // expected graph element count
     REQUIRE( c_ctx->type_table.end() - type_start == 10 ); // expected type table element count
     u32 op_scope = std::find_if( c_ctx->symbol_graph.begin(), c_ctx->symbol_graph.end(),
-                                 []( const SymbolGraphNode &node ) { return node.identifier.name == "op"; } ) -
+                                 []( const SymbolGraphNode &node ) { return node.identifier.name.str() == "op"; } ) -
                    c_ctx->symbol_graph.begin();
 
     // Create expected data
     u32 type_ctr = graph_start_idx;
+    auto ident = []( const char *name ) { return SymbolIdentifier{ InternedString( name ) }; };
     std::vector<SymbolGraphNode> expected_graph_nodes = {
-        SymbolGraphNode{ 1, {}, {}, SymbolIdentifier{ "A" }, {}, false, type_start_idx, c_ctx->struct_type },
+        SymbolGraphNode{ 1, {}, {}, ident( "A" ), {}, false, type_start_idx, c_ctx->struct_type },
+        SymbolGraphNode{ op_scope, {}, {}, ident( "Add" ), {}, false, type_start_idx + 1, c_ctx->trait_type },
+        SymbolGraphNode{ graph_start_idx + 1, {}, {}, ident( "add" ), {}, false, type_start_idx + 2, c_ctx->fn_type },
+        SymbolGraphNode{ graph_start_idx, {}, {}, ident( "add" ), {}, false, type_start_idx + 3, c_ctx->fn_type },
+        SymbolGraphNode{ graph_start_idx + 3, {}, {}, ident( "" ), {}, false, 0, 0 },
+        SymbolGraphNode{ 1, {}, {}, ident( "submodule" ), {}, false, 0, c_ctx->mod_type },
+        SymbolGraphNode{ graph_start_idx + 5, {}, {}, ident( "B" ), {}, false, type_start_idx + 4, c_ctx->struct_type },
+        SymbolGraphNode{ 1, {}, {}, ident( "base" ), {}, false, 0, c_ctx->mod_type },
+        SymbolGraphNode{ graph_start_idx + 7, {}, {}, ident( "B" ), {}, false, 0, c_ctx->mod_type },
+        SymbolGraphNode{ graph_start_idx + 8, {}, {}, ident( "A" ), {}, false, 0, c_ctx->mod_type },
+        SymbolGraphNode{ graph_start_idx + 9, {}, {}, ident( "b" ), {}, false, 0, c_ctx->mod_type },
+        SymbolGraphNode{ graph_start_idx + 10, {}, {}, ident( "a" ), {}, false, 0, c_ctx->mod_type },
         SymbolGraphNode{
-            op_scope, {}, {}, SymbolIdentifier{ "Add" }, {}, false, type_start_idx + 1, c_ctx->trait_type },
+            graph_start_idx + 11, {}, {}, ident( "function" ), {}, false, type_start_idx + 5, c_ctx->fn_type },
+        SymbolGraphNode{ graph_start_idx + 12, {}, {}, ident( "" ), {}, false, 0, 0 },
+        SymbolGraphNode{ graph_start_idx + 13, {}, {}, ident( "" ), {}, false, 0, 0 },
+        SymbolGraphNode{ graph_start_idx + 13, {}, {}, ident( "fn" ), {}, false, type_start_idx + 6, c_ctx->fn_type },
+        SymbolGraphNode{ graph_start_idx + 15, {}, {}, ident( "" ), {}, false, 0, 0 },
+        SymbolGraphNode{ 1, {}, {}, ident( "sub" ), {}, false, 0, c_ctx->mod_type },
         SymbolGraphNode{
-            graph_start_idx + 1, {}, {}, SymbolIdentifier{ "add" }, {}, false, type_start_idx + 2, c_ctx->fn_type },
-        SymbolGraphNode{
-            graph_start_idx, {}, {}, SymbolIdentifier{ "add" }, {}, false, type_start_idx + 3, c_ctx->fn_type },
-        SymbolGraphNode{ graph_start_idx + 3, {}, {}, SymbolIdentifier{ "" }, {}, false, 0, 0 },
-        SymbolGraphNode{ 1, {}, {}, SymbolIdentifier{ "submodule" }, {}, false, 0, c_ctx->mod_type },
-        SymbolGraphNode{
-            graph_start_idx + 5, {}, {}, SymbolIdentifier{ "B" }, {}, false, type_start_idx + 4, c_ctx->struct_type },
-        SymbolGraphNode{ 1, {}, {}, SymbolIdentifier{ "base" }, {}, false, 0, c_ctx->mod_type },
-        SymbolGraphNode{ graph_start_idx + 7, {}, {}, SymbolIdentifier{ "B" }, {}, false, 0, c_ctx->mod_type },
-        SymbolGraphNode{ graph_start_idx + 8, {}, {}, SymbolIdentifier{ "A" }, {}, false, 0, c_ctx->mod_type },
-        SymbolGraphNode{ graph_start_idx + 9, {}, {}, SymbolIdentifier{ "b" }, {}, false, 0, c_ctx->mod_type },
-        SymbolGraphNode{ graph_start_idx + 10, {}, {}, SymbolIdentifier{ "a" }, {}, false, 0, c_ctx->mod_type },
-        SymbolGraphNode{ graph_start_idx + 11,
-                         {},
-                         {},
-                         SymbolIdentifier{ "function" },
-                         {},
-                         false,
-                         type_start_idx + 5,
-                         c_ctx->fn_type },
-        SymbolGraphNode{ graph_start_idx + 12, {}, {}, SymbolIdentifier{ "" }, {}, false, 0, 0 },
-        SymbolGraphNode{ graph_start_idx + 13, {}, {}, SymbolIdentifier{ "" }, {}, false, 0, 0 },
-        SymbolGraphNode{
-            graph_start_idx + 13, {}, {}, SymbolIdentifier{ "fn" }, {}, false, type_start_idx + 6, c_ctx->fn_type },
-        SymbolGraphNode{ graph_start_idx + 15, {}, {}, SymbolIdentifier{ "" }, {}, false, 0, 0 },
-        SymbolGraphNode{ 1, {}, {}, SymbolIdentifier{ "sub" }, {}, false, 0, c_ctx->mod_type },
-        SymbolGraphNode{
-            graph_start_idx + 17, {}, {}, SymbolIdentifier{ "new_fn" }, {}, false, type_start_idx + 7, c_ctx->fn_type },
-        SymbolGraphNode{ graph_start_idx + 18, {}, {}, SymbolIdentifier{ "" }, {}, false, 0, 0 },
-        SymbolGraphNode{ 1, {}, {}, SymbolIdentifier{ "other_fn" }, {}, false, type_start_idx + 8, c_ctx->fn_type },
-        SymbolGraphNode{ graph_start_idx + 20, {}, {}, SymbolIdentifier{ "" }, {}, false, 0, 0 },
-        SymbolGraphNode{ 1, {}, {}, SymbolIdentifier{ "another_sub" }, {}, false, 0, c_ctx->mod_type },
-        SymbolGraphNode{
-            graph_start_idx + 22, {}, {}, SymbolIdentifier{ "fn" }, {}, false, type_start_idx + 9, c_ctx->fn_type },
-        SymbolGraphNode{ graph_start_idx + 23, {}, {}, SymbolIdentifier{ "" }, {}, false, 0, 0 },
+            graph_start_idx + 17, {}, {}, ident( "new_fn" ), {}, false, type_start_idx + 7, c_ctx->fn_type },
+        SymbolGraphNode{ graph_start_idx + 18, {}, {}, ident( "" ), {}, false, 0, 0 },
+        SymbolGraphNode{ 1, {}, {}, ident( "other_fn" ), {}, false, type_start_idx + 8, c_ctx->fn_type },
+        SymbolGraphNode{ graph_start_idx + 20, {}, {}, ident( "" ), {}, false, 0, 0 },
+        SymbolGraphNode{ 1, {}, {}, ident( "another_sub" ), {}, false, 0, c_ctx->mod_type },
+        SymbolGraphNode{ graph_start_idx + 22, {}, {}, ident( "fn" ), {}, false, type_start_idx + 9, c_ctx->fn_type },
+        SymbolGraphNode{ graph_start_idx + 23, {}, {}, ident( "" ), {}, false, 0, 0 },
     };
 
     for ( size_t i = graph_start_idx; i < c_ctx->symbol_graph.size(); i++ ) {
@@ -348,3 +340,271 @@ TEST_CASE( "Symbol discovery", "[semantic_parser]" ) {
         CHECK( generated.type == expected.type );
     }
 }
+
+// Records the order in which pass hooks are called
+static std::vector<std::tuple<char, bool, const AstNode *>> pass_hook_log;
+
+template <char Name, bool RequiresCompletedWalk>
+struct LoggingPass {
+    static constexpr VisitorPassType type = VisitorPassType::count;
+    static constexpr const char *name = "logging";
+    static constexpr bool requires_completed_walk = RequiresCompletedWalk;
+    static constexpr bool parallel = false;
+
+    static bool pre( AstNode &node, AstNode &parent, bool &expect_operand, CrateCtx &c_ctx, TraversalCtx &t_ctx,
+                     Worker &w_ctx ) {
+        pass_hook_log.push_back( std::make_tuple( Name, true, &node ) );
+        return true;
+    }
+    static bool post( AstNode &node, CrateCtx &c_ctx, TraversalCtx &t_ctx, Worker &w_ctx ) {
+        pass_hook_log.push_back( std::make_tuple( Name, false, &node ) );
+        return true;
+    }
+};
+
+TEST_CASE( "Visitor pass fusion", "[semantic_parser]" ) {
+    auto g_ctx = make_shared<GlobalCtx>();
+    auto w_ctx = g_ctx->setup( 1 );
+    CrateCtx c_ctx;
+
+    AstNode root{ ExprType::decl_scope };
+    root.children.push_back( AstNode{ ExprType::unit } );
+    root.named[AstChild::symbol] = AstNode{ ExprType::atomic_symbol };
+    auto *child = &root.children.front();
+    auto *named = &root.named[AstChild::symbol];
+
+    // Fused passes
+    pass_hook_log.clear();
+    size_t walk_count = 0;
+    CHECK( run_visitor_passes<LoggingPass<'a', false>, LoggingPass<'b', false>>( root, c_ctx, *w_ctx, walk_count ) );
+    CHECK( walk_count == 1 );
+    std::vector<std::tuple<char, bool, const AstNode *>> expected = {
+        { 'a', true, &root },   { 'b', true, &root },   { 'a', true, named },  { 'b', true, named },
+        { 'b', false, named },  { 'a', false, named },  { 'a', true, child },  { 'b', true, child },
+        { 'b', false, child },  { 'a', false, child },  { 'b', false, &root }, { 'a', false, &root },
+    };
+    CHECK( pass_hook_log == expected );
+
+    // A pass which requires a completed walk starts a new traversal
+    pass_hook_log.clear();
+    walk_count = 0;
+    CHECK( run_visitor_passes<LoggingPass<'a', false>, LoggingPass<'b', true>, LoggingPass<'c', false>>(
+        root, c_ctx, *w_ctx, walk_count ) );
+    CHECK( walk_count == 2 );
+    expected = {
+        { 'a', true, &root },  { 'a', true, named },  { 'a', false, named }, { 'a', true, child },
+        { 'a', false, child }, { 'a', false, &root }, { 'b', true, &root },  { 'c', true, &root },
+        { 'b', true, named },  { 'c', true, named },  { 'c', false, named }, { 'b', false, named },
+        { 'b', true, child },  { 'c', true, child },  { 'c', false, child }, { 'b', false, child },
+        { 'c', false, &root }, { 'b', false, &root },
+    };
+    CHECK( pass_hook_log == expected );
+}
+
+TEST_CASE( "Deep AST traversal", "[semantic_parser]" ) {
+    auto g_ctx = make_shared<GlobalCtx>();
+    auto w_ctx = g_ctx->setup( 1 );
+    CrateCtx c_ctx;
+
+    // Builds a chain of terms around a literal
+    auto build_chain = []( size_t depth ) {
+        AstNode node{ ExprType::numeric_literal };
+        node.literal_number = 1;
+        for ( size_t i = 0; i < depth; i++ ) {
+            AstNode term{ ExprType::term };
+            term.children.push_back( std::move( node ) );
+            node = std::move( term );
+        }
+        return node;
+    };
+    // The destructor is recursive, so the chain is torn down from the innermost node
+    auto tear_down_chain = []( AstNode &root ) {
+        std::vector<AstNode *> chain;
+        for ( AstNode *node = &root; !node->children.empty(); node = &node->children.front() )
+            chain.push_back( node );
+        for ( auto itr = chain.rbegin(); itr != chain.rend(); itr++ )
+            ( *itr )->children.clear();
+    };
+
+    // Much deeper than a recursive traversal could handle on the stack of a worker
+    constexpr size_t visit_depth = 200000;
+    AstNode root = build_chain( visit_depth );
+    pass_hook_log.clear();
+    CHECK( run_visitor_passes<LoggingPass<'a', false>>( root, c_ctx, *w_ctx ) );
+    REQUIRE( pass_hook_log.size() == 2 * ( visit_depth + 1 ) );
+    CHECK( pass_hook_log.front() == std::make_tuple( 'a', true, static_cast<const AstNode *>( &root ) ) );
+    CHECK( std::get<1>( pass_hook_log[visit_depth] ) );
+    CHECK( !std::get<1>( pass_hook_log[visit_depth + 1] ) );
+    CHECK( std::get<2>( pass_hook_log[visit_depth] ) == std::get<2>( pass_hook_log[visit_depth + 1] ) );
+    CHECK( pass_hook_log.back() == std::make_tuple( 'a', false, static_cast<const AstNode *>( &root ) ) );
+    pass_hook_log.clear();
+    tear_down_chain( root );
+
+    // The representation grows with the depth, so this chain is shorter
+    constexpr size_t repr_depth = 5000;
+    root = build_chain( repr_depth );
+    String expected;
+    for ( size_t i = 0; i < repr_depth; i++ )
+        expected += "TERM( ";
+    expected += "BLOB_LITERAL(1)";
+    for ( size_t i = 0; i < repr_depth; i++ )
+        expected += " )";
+    CHECK( root.get_debug_repr() == expected );
+    tear_down_chain( root );
+}
+
+TEST_CASE( "Symbol lookup index", "[semantic_parser]" ) {
+    auto g_ctx = make_shared<GlobalCtx>();
+    auto w_ctx = g_ctx->setup( 1 );
+    CrateCtx c_ctx;
+
+    // Many siblings in one scope
+    constexpr size_t symbol_count = 5000;
+    auto name_of = []( size_t i ) { return SymbolIdentifier{ InternedString( "s" + to_string( i ) ) }; };
+    std::vector<SymbolId> symbols;
+    for ( size_t i = 0; i < symbol_count; i++ ) {
+        symbols.push_back( create_new_relative_symbol( c_ctx, *w_ctx, name_of( i ), ROOT_SYMBOL ) );
+    }
+    for ( size_t i = 0; i < symbol_count; i += 499 ) {
+        auto found = find_sub_symbol_by_identifier( c_ctx, *w_ctx, name_of( i ), ROOT_SYMBOL );
+        REQUIRE( found.size() == 1 );
+        CHECK( found.front() == symbols[i] );
+    }
+    CHECK( find_sub_symbol_by_identifier( c_ctx, *w_ctx, SymbolIdentifier{ InternedString( "unknown" ) }, ROOT_SYMBOL )
+               .empty() );
+
+    // Overloads are filtered by their signature and keep their creation order
+    SymbolId scope = symbols.front();
+    SymbolIdentifier overload{ InternedString( "f" ) };
+    overload.parameters.resize( 1 );
+    overload.parameters.front().type = TYPE_UNIT;
+    SymbolId first = create_new_relative_symbol( c_ctx, *w_ctx, overload, scope );
+    overload.parameters.front().type = TYPE_NEVER;
+    SymbolId second = create_new_relative_symbol( c_ctx, *w_ctx, overload, scope );
+    SymbolId anonymous = create_new_relative_symbol( c_ctx, *w_ctx, SymbolIdentifier{}, scope );
+    CHECK( find_sub_symbol_by_identifier( c_ctx, *w_ctx, SymbolIdentifier{ InternedString( "f" ) }, scope ) ==
+           std::vector<SymbolId>{ first, second } );
+    CHECK( find_sub_symbol_by_identifier( c_ctx, *w_ctx, overload, scope ) == std::vector<SymbolId>{ second } );
+    CHECK( find_sub_symbol_by_identifier( c_ctx, *w_ctx, SymbolIdentifier{}, scope ) ==
+           std::vector<SymbolId>{ anonymous } );
+
+    // Relative lookups search the outer scopes
+    auto chain = make_shared<std::vector<SymbolIdentifier>>( 1, SymbolIdentifier{ InternedString( "s42" ) } );
+    CHECK( find_relative_symbol_by_identifier_chain( c_ctx, *w_ctx, chain, anonymous ) ==
+           std::vector<SymbolId>{ symbols[42] } );
+
+    // Template instantiations are searched among the children with the same name
+    SymbolIdentifier templ{ InternedString( "f" ) };
+    templ.template_values.push_back( std::make_pair( TYPE_TYPE, ConstValue() ) );
+    SymbolId template_symbol = create_new_relative_symbol( c_ctx, *w_ctx, templ, symbols.back() );
+    create_new_relative_symbol( c_ctx, *w_ctx, overload, symbols.back() );
+    CHECK( find_template_instantiations( c_ctx, *w_ctx, template_symbol ) == std::vector<SymbolId>{ template_symbol } );
+}
+
+TEST_CASE( "Template instantiation", "[semantic_parser]" ) {
+    auto g_ctx = make_shared<GlobalCtx>();
+    auto w_ctx = g_ctx->setup( 1 );
+    CrateCtx c_ctx;
+
+    // Two templates with the same parameters in different scopes
+    auto create_template = [&]( SymbolId parent ) {
+        SymbolIdentifier identifier{ InternedString( "T" ) };
+        identifier.template_values.push_back( std::make_pair( TYPE_TYPE, ConstValue() ) );
+        SymbolId templ = create_new_relative_symbol( c_ctx, *w_ctx, identifier, parent );
+        c_ctx.type_table[create_new_type( c_ctx, *w_ctx, templ )].additional_mem_size = 8;
+        return templ;
+    };
+    SymbolId scope =
+        create_new_relative_symbol( c_ctx, *w_ctx, SymbolIdentifier{ InternedString( "scope" ) }, ROOT_SYMBOL );
+    SymbolId first_template = create_template( ROOT_SYMBOL );
+    SymbolId second_template = create_template( scope );
+
+    auto values_of = []( TypeId type ) {
+        return std::vector<std::pair<TypeId, ConstValue>>{ std::make_pair( TYPE_TYPE, ConstValue( type ) ) };
+    };
+    auto unit_values = values_of( TYPE_UNIT );
+    auto never_values = values_of( TYPE_NEVER );
+    CHECK( hash_template_values( unit_values ) == hash_template_values( values_of( TYPE_UNIT ) ) );
+
+    // Every instantiation is created exactly once per template
+    SymbolId unit_instance = instantiate_template( c_ctx, *w_ctx, first_template, unit_values );
+    SymbolId never_instance = instantiate_template( c_ctx, *w_ctx, first_template, never_values );
+    SymbolId other_instance = instantiate_template( c_ctx, *w_ctx, second_template, unit_values );
+    CHECK( unit_instance != never_instance );
+    CHECK( unit_instance != other_instance );
+    CHECK( instantiate_template( c_ctx, *w_ctx, first_template, unit_values ) == unit_instance );
+    CHECK( instantiate_template( c_ctx, *w_ctx, first_template, never_values ) == never_instance );
+    CHECK( instantiate_template( c_ctx, *w_ctx, second_template, unit_values ) == other_instance );
+    CHECK( find_template_instantiations( c_ctx, *w_ctx, first_template ) ==
+           std::vector<SymbolId>{ first_template, unit_instance, never_instance } );
+    CHECK( c_ctx.symbol_graph[other_instance].parent == scope );
+
+    // Instances copy the type of their template
+    auto &instance_type = c_ctx.type_table[c_ctx.symbol_graph[unit_instance].value];
+    CHECK( instance_type.symbol == unit_instance );
+    CHECK( instance_type.additional_mem_size == 8 );
+}
+
+static void test_symbol_parser( const String &data, sptr<PreludeConfig> config, bool parallel, JobsBuilder &jb,
+                                UnitCtx &parent_ctx ) {
+    jb.add_job<sptr<CrateCtx>>( [data, config, parallel]( Worker &w_ctx ) {
+        w_ctx.global_ctx()->set_pref<BoolSV>( PrefType::parallel_parsing, parallel );
+        sptr<SourceInput> input =
+            make_shared<StringInput>( make_shared<String>( "test" ), w_ctx.shared_from_this(), data );
+        input->configure( config->token_conf );
+        w_ctx.unit_ctx()->prelude_conf = *config;
+
+        auto c_ctx = make_shared<CrateCtx>();
+        load_base_types( *c_ctx, w_ctx, w_ctx.unit_ctx()->prelude_conf );
+        load_syntax_rules( w_ctx, *c_ctx );
+
+        *c_ctx->ast = parse_scope( input, w_ctx, *c_ctx, Token::Type::eof, nullptr );
+        w_ctx.do_query( parse_symbols, c_ctx );
+        return c_ctx;
+    } );
+}
+
+TEST_CASE( "Parallel visitor passes", "[semantic_parser]" ) {
+    auto g_ctx = make_shared<GlobalCtx>();
+    auto w_ctx = g_ctx->setup( 4 );
+
+    auto config = make_shared<PreludeConfig>();
+    *config = w_ctx->do_query( load_prelude, make_shared<String>( "push" ) )->jobs.back()->to<PreludeConfig>();
+
+    String valid_data = "use al = other::path;";
+    String invalid_data;
+    for ( size_t i = 0; i < 40; i++ ) {
+        String item = "struct S" + to_string( i ) + " { a, b:al } f" + to_string( i ) + "(x) { { let y = x; } } mod m" +
+                      to_string( i ) + " { g { } } ";
+        item += "impl S" + to_string( ( i + 25 ) % 40 ) + " { h" + to_string( i ) + "(x) { } } "; // re-opens a struct
+        valid_data += item;
+        invalid_data += item + ( i % 10 == 3 ? "x[0,1];" : "" ) + ( i % 10 == 7 ? "struct A { fn(){} }" : "" );
+    }
+
+    for ( auto &data : { valid_data, invalid_data } ) {
+        auto sequential = w_ctx->do_query( test_symbol_parser, data, config, false )->jobs.back()->to<sptr<CrateCtx>>();
+        auto sequential_log = g_ctx->get_message_log();
+        g_ctx->clear_messages();
+
+        auto parallel = w_ctx->do_query( test_symbol_parser, data, config, true )->jobs.back()->to<sptr<CrateCtx>>();
+        auto parallel_log = g_ctx->get_message_log();
+        g_ctx->clear_messages();
+
+        CHECK( parallel->ast->get_debug_repr() == sequential->ast->get_debug_repr() );
+        REQUIRE( parallel->symbol_graph.size() == sequential->symbol_graph.size() );
+        for ( size_t i = 1; i < sequential->symbol_graph.size(); i++ ) {
+            CHECK( parallel->symbol_graph[i].parent == sequential->symbol_graph[i].parent );
+            CHECK( parallel->symbol_graph[i].identifier.name == sequential->symbol_graph[i].identifier.name );
+            CHECK( parallel->symbol_graph[i].sub_nodes == sequential->symbol_graph[i].sub_nodes );
+            CHECK( parallel->symbol_graph[i].original_expr.size() == sequential->symbol_graph[i].original_expr.size() );
+            CHECK( parallel->symbol_graph[i].value == sequential->symbol_graph[i].value );
+            CHECK( parallel->symbol_graph[i].type == sequential->symbol_graph[i].type );
+        }
+        CHECK( parallel->type_table.size() == sequential->type_table.size() );
+        REQUIRE( parallel_log.size() == sequential_log.size() );
+        for ( size_t i = 0; i < sequential_log.size(); i++ ) {
+            CHECK( parallel_log[i].first == sequential_log[i].first );
+            CHECK( parallel_log[i].second.column == sequential_log[i].second.column );
+        }
+    }
+}
@@ -30,6 +30,9 @@ class CLI {
     // Prints the help text into the console
     void print_help_text();
 
+    // Prints the stats of all measured compiler stages into the console
+    void print_pass_stats( GlobalCtx& g_ctx );
+
     // Returns true if the CLI has this preference name
     static bool find_pref( const String& pref );
     // Returns true if the CLI has this flag name
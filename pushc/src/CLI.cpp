@@ -176,6 +176,29 @@ int CLI::fill_config( std::map<String, String>& config_list, const String& arg_n
     return RET_SUCCESS;
 }
 
+void CLI::print_pass_stats( GlobalCtx& g_ctx ) {
+    bool heap_counted = heap_stats_available();
+    std::stringstream ss;
+    ss << std::left << std::setw( 28 ) << "Stage" << std::right << std::setw( 6 ) << "Runs" << std::setw( 12 )
+       << "Wall ms" << std::setw( 12 ) << "CPU ms" << std::setw( 12 ) << "Nodes" << std::setw( 12 ) << "Allocs"
+       << std::setw( 12 ) << "Peak KB" << "\n";
+    for ( auto& stats : g_ctx.get_pass_stats() ) {
+        ss << std::left << std::setw( 28 ) << stats.name << std::right << std::setw( 6 ) << stats.runs << std::fixed
+           << std::setprecision( 3 ) << std::setw( 12 ) << stats.wall_seconds * 1000 << std::setw( 12 )
+           << stats.cpu_seconds * 1000 << std::setw( 12 ) << stats.nodes;
+        if ( heap_counted )
+            ss << std::setw( 12 ) << stats.allocations << std::setw( 12 ) << stats.peak_bytes / 1024;
+        else
+            ss << std::setw( 12 ) << "-" << std::setw( 12 ) << "-";
+        ss << "\n";
+    }
+    if ( heap_counted ) {
+        auto heap = get_heap_stats();
+        ss << "Total: " << heap.allocations << " allocations, " << heap.peak_bytes / 1024 << " KB peak heap\n";
+    }
+    std::cout << ss.str();
+}
+
 size_t CLI::get_cpu_count() {
     // TODO
     return 4;
@@ -223,6 +246,7 @@ int CLI::execute() {
         std::list<String> output_files; // TODO
         bool run_afterwards = false;
         bool clean_build = false;
+        bool time_passes = false;
         String explicit_prelude; // TODO
         size_t thread_count = 0;
         String color = "auto"; // TODO
@@ -248,7 +272,7 @@ int CLI::execute() {
             } else if ( arg.first == "--config" || arg.first == "-c" ) {
                 if ( !check_par( arg ) )
                     return RET_COMMAND_ERROR;
-                int ret = fill_triplet( config_list, arg.first, arg.second );
+                int ret = fill_config( config_list, arg.first, arg.second );
                 if ( ret != RET_SUCCESS )
                     return ret;
             } else if ( arg.first == "--prelude" ) {
@@ -269,6 +293,8 @@ int CLI::execute() {
                 color = arg.second.back();
             } else if ( arg.first == "--clean" ) {
                 clean_build = true;
+            } else if ( arg.first == "--time-passes" ) {
+                time_passes = true;
             } else if ( arg.first != "--help" && arg.first != "-h" && arg.first != "--version" && arg.first != "-v" ) {
                 std::cout << "Unknown option \"" + arg.first + "\"\n";
                 return RET_COMMAND_ERROR;
@@ -294,6 +320,7 @@ int CLI::execute() {
         for ( auto& t : triplet_list ) {
             store_triplet_elem( *g_ctx, t.first, t.second );
         }
+        g_ctx->set_pref<BoolSV>( PrefType::time_passes, time_passes );
 
         // Do some preparation
         if ( files.empty() ) { // find project file or .push files TODO
@@ -306,6 +333,9 @@ int CLI::execute() {
             w_ctx->do_query( compile_new_unit, file );
         }
 
+        if ( time_passes )
+            print_pass_stats( *g_ctx );
+
         if ( run_afterwards ) { // execute now TODO
         }
     }
@@ -40,6 +40,9 @@ void CLI::print_help_text() {
                  "                             (De-)Activate coloring of the output messages.\n";
     std::cout << "  --clean [global]           Deletes the build output and cache. With \"global\"\n"
                  "                               the user-global cache is deleted too.\n";
+    std::cout << "  --time-passes              Print the time, processed nodes, allocations and\n"
+                 "                               peak heap memory of each compiler stage. Nested\n"
+                 "                               stages are included in the outer ones.\n";
     std::cout << "\n";
     std::cout << "Any of the above options may be passed in any order. The files may also be\n"
                  "passed in between two or more options or before an option. Every option\n"
@@ -59,5 +62,10 @@ void CLI::print_help_text() {
                  "  <architecture>-<os/kernel/framework;specification>-<plattform/vendor>-\n"
                  "  <output_format>-<backend>-<runtime>-<linkage>-<build_configuration> \n"
                  "You may configure parts of the triplet and leave the remaining defaults with\n"
-                 "a comma-separated list or <name>=<value> pairs.\n";
+                 "a comma-separated list or <name>=<value> pairs.\n"
+                 "\n";
+    std::cout << "Available flags and preferences for --config:\n";
+    std::cout << "  lto[=<bool>]/no_lto        (De-)Activate Link-Time Optimization.\n";
+    std::cout << "  ast_cache=<directory>      Cache the parsed AST of files in this directory.\n"
+                 "                               Unchanged files are loaded instead of parsed.\n";
 }
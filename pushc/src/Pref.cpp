@@ -35,7 +35,7 @@ bool get_boolean_flag( const String& str ) {
 
 
 bool CLI::find_pref( const String& pref ) {
-    return pref == "lto";
+    return pref == "lto" || pref == "ast_cache";
 }
 bool CLI::find_flag( const String& flag ) {
     return flag == "lto" || flag == "no_lto";
@@ -46,6 +46,14 @@ bool CLI::store_config( GlobalCtx& g_ctx, const String& name, const String& valu
         if ( !check_boolean_flag( value ) )
             return false;
         g_ctx.set_pref<BoolSV>( PrefType::lto, get_boolean_flag( value ) );
+    } else if ( name == "no_lto" ) {
+        g_ctx.set_pref<BoolSV>( PrefType::lto, false );
+    } else if ( name == "ast_cache" ) {
+        if ( value.empty() )
+            return false;
+        g_ctx.set_pref<StringSV>( PrefType::ast_cache_dir, value );
+    } else {
+        return false;
     }
-    return false;
+    return true;
 }